@@ -0,0 +1,180 @@
+#include "bench.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+namespace bench {
+
+void State::setCounter(const std::string& name, double value)
+{
+    for (auto& counter : counters) {
+        if (counter.first == name) {
+            counter.second = value;
+            return;
+        }
+    }
+    counters.emplace_back(name, value);
+}
+
+void Runner::add(const std::string& name, Function fn, u64 fixed_iterations)
+{
+    entries.push_back({ name, std::move(fn), fixed_iterations });
+}
+
+Result Runner::run(const Entry& entry) const
+{
+    u64 iterations = entry.fixed_iterations ? entry.fixed_iterations : 1;
+
+    while (true) {
+        State state(iterations);
+        entry.fn(state);
+
+        if (state.hasError() || !state.hasStarted()) {
+            Result result;
+            result.name = entry.name;
+            result.error_occurred = true;
+            result.error_message = state.hasError() ? state.getError() : "benchmark body never ran";
+            return result;
+        }
+
+        const double real = state.getRealSeconds();
+        const double cpu = state.getCpuSeconds();
+
+        if (entry.fixed_iterations || real >= min_time || iterations >= (1ULL << 40)) {
+            Result result;
+            result.name = entry.name;
+            result.iterations = iterations;
+            result.real_ns = real * 1e9 / iterations;
+            result.cpu_ns = cpu * 1e9 / iterations;
+            if (state.getItemsPerIteration() && real > 0.0) {
+                result.items_per_second = static_cast<double>(state.getItemsPerIteration()) * iterations / real;
+            }
+            result.counters = state.getCounters();
+            return result;
+        }
+
+        // Scale towards the minimum time, like Google Benchmark does
+        double multiplier = real > 0.0 ? (min_time * 1.4) / real : 10.0;
+        if (multiplier > 10.0) multiplier = 10.0;
+        if (multiplier < 2.0) multiplier = 2.0;
+        iterations = static_cast<u64>(iterations * multiplier);
+    }
+}
+
+void Runner::runAll()
+{
+    results.clear();
+    for (const auto& entry : entries) {
+        if (!filter.empty() && entry.name.find(filter) == std::string::npos) continue;
+
+        std::cerr << "Running " << entry.name << "..." << std::endl;
+        results.push_back(run(entry));
+        if (results.back().error_occurred) {
+            std::cerr << "  FAILED: " << results.back().error_message << std::endl;
+        }
+    }
+}
+
+bool Runner::hasErrors() const
+{
+    for (const auto& r : results) {
+        if (r.error_occurred) return true;
+    }
+    return false;
+}
+
+void Runner::printTable() const
+{
+    std::printf("%-40s %15s %15s %12s %14s\n", "Benchmark", "Time (ns)", "CPU (ns)", "Iterations", "Items/s");
+    std::printf("%s\n", std::string(100, '-').c_str());
+    for (const auto& r : results) {
+        if (r.error_occurred) {
+            std::printf("%-40s ERROR: %s\n", r.name.c_str(), r.error_message.c_str());
+            continue;
+        }
+        std::printf("%-40s %15.1f %15.1f %12llu", r.name.c_str(), r.real_ns, r.cpu_ns,
+                    static_cast<unsigned long long>(r.iterations));
+        if (r.items_per_second > 0.0) {
+            std::printf(" %14.4g", r.items_per_second);
+        }
+        for (const auto& counter : r.counters) {
+            std::printf(" %s=%.4g", counter.first.c_str(), counter.second);
+        }
+        std::printf("\n");
+    }
+}
+
+static std::string jsonEscape(const std::string& s)
+{
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+std::string Runner::toJson() const
+{
+    std::ostringstream out;
+    out.precision(17);
+
+    char date[64];
+    const std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+
+    out << "{\n";
+    out << "  \"context\": {\n";
+    out << "    \"date\": \"" << date << "\",\n";
+    out << "    \"executable\": \"vnes-bench\",\n";
+    out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+    out << "    \"library_build_type\": \"release\"\n";
+#else
+    out << "    \"library_build_type\": \"debug\"\n";
+#endif
+    out << "  },\n";
+    out << "  \"benchmarks\": [";
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const auto& r = results[i];
+        out << (i ? ",\n" : "\n");
+        out << "    {\n";
+        out << "      \"name\": \"" << jsonEscape(r.name) << "\",\n";
+        out << "      \"run_name\": \"" << jsonEscape(r.name) << "\",\n";
+        out << "      \"run_type\": \"iteration\",\n";
+        if (r.error_occurred) {
+            // Google Benchmark's error fields, and no timings to compare
+            out << "      \"error_occurred\": true,\n";
+            out << "      \"error_message\": \"" << jsonEscape(r.error_message) << "\"\n";
+            out << "    }";
+            continue;
+        }
+        out << "      \"iterations\": " << r.iterations << ",\n";
+        out << "      \"real_time\": " << r.real_ns << ",\n";
+        out << "      \"cpu_time\": " << r.cpu_ns << ",\n";
+        out << "      \"time_unit\": \"ns\"";
+        if (r.items_per_second > 0.0) {
+            out << ",\n      \"items_per_second\": " << r.items_per_second;
+        }
+        for (const auto& counter : r.counters) {
+            out << ",\n      \"" << jsonEscape(counter.first) << "\": " << counter.second;
+        }
+        out << "\n    }";
+    }
+
+    out << "\n  ]\n}\n";
+    return out.str();
+}
+
+bool Runner::writeJson(const std::string& path) const
+{
+    std::ofstream file(path);
+    if (!file) return false;
+    file << toJson();
+    return static_cast<bool>(file);
+}
+
+} // namespace bench
@@ -0,0 +1,140 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <chrono>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <vector>
+#include "types.h"
+
+// Minimal Google Benchmark style harness. Each benchmark body loops on
+// `while (state.keepRunning())`; the runner grows the iteration count until
+// a run lasts at least the minimum time, then reports per-iteration timings.
+// Results are written in the same JSON layout as --benchmark_format=json so
+// existing comparison tooling can consume them.
+
+namespace bench {
+
+// Prevents the compiler from discarding a computed value
+template<typename T>
+inline void doNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
+
+class State {
+public:
+    explicit State(u64 iterations) : remaining(iterations), iterations(iterations) {}
+
+    // Timing covers only the loop: it starts on the first call and stops on
+    // the call that ends the loop, so per-benchmark setup is excluded
+    bool keepRunning()
+    {
+        if (!started) {
+            started = true;
+            cpu_start = std::clock();
+            start = std::chrono::steady_clock::now();
+        }
+        if (remaining == 0) {
+            end = std::chrono::steady_clock::now();
+            cpu_end = std::clock();
+            return false;
+        }
+        remaining--;
+        return true;
+    }
+
+    u64 getIterations() const { return iterations; }
+    double getRealSeconds() const { return std::chrono::duration<double>(end - start).count(); }
+    double getCpuSeconds() const { return static_cast<double>(cpu_end - cpu_start) / CLOCKS_PER_SEC; }
+
+    // Work units processed per iteration (reported as items_per_second)
+    void setItemsPerIteration(u64 items) { items_per_iteration = items; }
+    u64 getItemsPerIteration() const { return items_per_iteration; }
+
+    // Extra numeric counters reported alongside the timings
+    void setCounter(const std::string& name, double value);
+    const std::vector<std::pair<std::string, double>>& getCounters() const { return counters; }
+
+    // Mark the run as failed (e.g. its setup could not be built) and return
+    // from the benchmark; the runner reports the error instead of a timing
+    void skipWithError(const std::string& message) { error = message; failed = true; }
+    bool hasError() const { return failed; }
+    const std::string& getError() const { return error; }
+
+    // Whether the body entered its keepRunning() loop
+    bool hasStarted() const { return started; }
+
+private:
+    u64 remaining;
+    u64 iterations;
+    u64 items_per_iteration = 0;
+    std::vector<std::pair<std::string, double>> counters;
+    bool failed = false;
+    std::string error;
+
+    bool started = false;
+    std::chrono::steady_clock::time_point start{};
+    std::chrono::steady_clock::time_point end{};
+    std::clock_t cpu_start = 0;
+    std::clock_t cpu_end = 0;
+};
+
+struct Result {
+    std::string name;
+    u64 iterations = 0;
+    double real_ns = 0.0;   // per iteration
+    double cpu_ns = 0.0;    // per iteration
+    double items_per_second = 0.0;
+    std::vector<std::pair<std::string, double>> counters;
+    bool error_occurred = false;    // no timings; see error_message
+    std::string error_message;
+};
+
+using Function = std::function<void(State&)>;
+
+class Runner {
+public:
+    // Benchmarks with fixed_iterations > 0 run exactly that many times
+    // (used by the macro benchmarks, where one iteration is a whole run)
+    void add(const std::string& name, Function fn, u64 fixed_iterations = 0);
+
+    void setMinTime(double seconds) { min_time = seconds; }
+    void setFilter(const std::string& f) { filter = f; }
+
+    void runAll();
+
+    // True if any benchmark in the last runAll() failed
+    bool hasErrors() const;
+
+    // Human-readable table on stdout
+    void printTable() const;
+
+    // Google Benchmark compatible JSON
+    bool writeJson(const std::string& path) const;
+    std::string toJson() const;
+
+private:
+    struct Entry {
+        std::string name;
+        Function fn;
+        u64 fixed_iterations;
+    };
+
+    Result run(const Entry& entry) const;
+
+    std::vector<Entry> entries;
+    std::vector<Result> results;
+    double min_time = 0.5;
+    std::string filter;
+};
+
+} // namespace bench
+
+#endif // BENCH_H
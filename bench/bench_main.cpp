@@ -0,0 +1,547 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "bench.h"
+#include "bus.h"
+#include "hq2x.h"
+#include "mapper.h"
+#include "util.h"
+#include "verify.h"
+
+// VNES benchmark suite
+//
+// Micro benchmarks cover the hot paths individually (CPU instruction
+// dispatch, PPU dots, APU synthesis, HQ2x scaling, mapper bank lookups);
+// macro benchmarks run a ROM headless for a fixed number of frames.
+// Everything needed is synthesized here so `make bench` runs without ROMs.
+
+namespace {
+
+const u16 RESET_VECTOR = 0x8000;
+
+// Small NROM program: loads a palette, fills nametable 0 and OAM, starts a
+// pulse tone, enables NMI + background/sprite rendering, then spins in a
+// RAM read-modify-write loop. The NMI handler does OAM DMA and scrolls.
+const u8 renderProgram[] = {
+    // reset:
+    0x78,                    // SEI
+    0xD8,                    // CLD
+    0xA2, 0xFF,              // LDX #$FF
+    0x9A,                    // TXS
+    0xA9, 0x00,              // LDA #$00
+    0x8D, 0x00, 0x20,        // STA $2000
+    0x8D, 0x01, 0x20,        // STA $2001
+    // vb1:
+    0x2C, 0x02, 0x20,        // BIT $2002
+    0x10, 0xFB,              // BPL vb1
+    // vb2:
+    0x2C, 0x02, 0x20,        // BIT $2002
+    0x10, 0xFB,              // BPL vb2
+    0xA9, 0x3F,              // LDA #$3F
+    0x8D, 0x06, 0x20,        // STA $2006
+    0xA9, 0x00,              // LDA #$00
+    0x8D, 0x06, 0x20,        // STA $2006
+    0xA2, 0x00,              // LDX #$00
+    // pal:
+    0x8A,                    // TXA
+    0x8D, 0x07, 0x20,        // STA $2007
+    0xE8,                    // INX
+    0xE0, 0x20,              // CPX #$20
+    0xD0, 0xF7,              // BNE pal
+    0xA9, 0x20,              // LDA #$20
+    0x8D, 0x06, 0x20,        // STA $2006
+    0xA9, 0x00,              // LDA #$00
+    0x8D, 0x06, 0x20,        // STA $2006
+    0xA0, 0x04,              // LDY #$04
+    // nt:
+    0x8A,                    // TXA
+    0x8D, 0x07, 0x20,        // STA $2007
+    0xE8,                    // INX
+    0xD0, 0xF9,              // BNE nt
+    0x88,                    // DEY
+    0xD0, 0xF6,              // BNE nt
+    // spr:
+    0x8A,                    // TXA
+    0x9D, 0x00, 0x02,        // STA $0200,X
+    0xE8,                    // INX
+    0xD0, 0xF9,              // BNE spr
+    0xA9, 0x0F,              // LDA #$0F
+    0x8D, 0x15, 0x40,        // STA $4015
+    0xA9, 0xBF,              // LDA #$BF
+    0x8D, 0x00, 0x40,        // STA $4000
+    0xA9, 0x80,              // LDA #$80
+    0x8D, 0x02, 0x40,        // STA $4002
+    0xA9, 0x02,              // LDA #$02
+    0x8D, 0x03, 0x40,        // STA $4003
+    0xA9, 0x00,              // LDA #$00
+    0x8D, 0x05, 0x20,        // STA $2005
+    0x8D, 0x05, 0x20,        // STA $2005
+    0xA9, 0x90,              // LDA #$90
+    0x8D, 0x00, 0x20,        // STA $2000
+    0xA9, 0x1E,              // LDA #$1E
+    0x8D, 0x01, 0x20,        // STA $2001
+    // main ($806F):
+    0xA5, 0x00,              // LDA $00
+    0x18,                    // CLC
+    0x69, 0x01,              // ADC #$01
+    0x85, 0x00,              // STA $00
+    0xAA,                    // TAX
+    0xBD, 0x00, 0x03,        // LDA $0300,X
+    0x45, 0x01,              // EOR $01
+    0x9D, 0x00, 0x03,        // STA $0300,X
+    0xE6, 0x01,              // INC $01
+    0x4C, 0x6F, 0x80,        // JMP main
+    // nmi ($8084):
+    0x48,                    // PHA
+    0xA9, 0x02,              // LDA #$02
+    0x8D, 0x14, 0x40,        // STA $4014
+    0xE6, 0x02,              // INC $02
+    0xA5, 0x02,              // LDA $02
+    0x8D, 0x05, 0x20,        // STA $2005
+    0x8D, 0x05, 0x20,        // STA $2005
+    0x68,                    // PLA
+    // irq ($8095):
+    0x40,                    // RTI
+};
+const u16 RENDER_NMI = 0x8084;
+const u16 RENDER_IRQ = 0x8095;
+
+// Instruction mixes for the CPU micro benchmarks. Each pattern is tiled
+// across the PRG bank and ends in JMP $8000.
+const std::vector<u8> aluPattern = {
+    0xA9, 0x35,              // LDA #$35
+    0x69, 0x17,              // ADC #$17
+    0x29, 0xF0,              // AND #$F0
+    0x45, 0x10,              // EOR $10
+    0x05, 0x11,              // ORA $11
+    0xC9, 0x80,              // CMP #$80
+    0xAA,                    // TAX
+    0xE8,                    // INX
+    0x88,                    // DEY
+    0x2A,                    // ROL A
+};
+const std::vector<u8> memoryPattern = {
+    0xBD, 0x00, 0x03,        // LDA $0300,X
+    0x99, 0x00, 0x04,        // STA $0400,Y
+    0xB1, 0x20,              // LDA ($20),Y
+    0x95, 0x40,              // STA $40,X
+    0xAD, 0x00, 0x05,        // LDA $0500
+    0xE8,                    // INX
+    0xC8,                    // INY
+};
+const std::vector<u8> rmwPattern = {
+    0xE6, 0x30,              // INC $30
+    0x0E, 0x00, 0x03,        // ASL $0300
+    0x76, 0x31,              // ROR $31,X
+    0xDE, 0x00, 0x04,        // DEC $0400,X
+    0xE8,                    // INX
+};
+const std::vector<u8> branchPattern = {
+    0xA2, 0x08,              // LDX #$08
+    0xCA,                    // DEX
+    0xD0, 0xFD,              // BNE -3
+    0x18,                    // CLC
+    0x90, 0x00,              // BCC +0
+};
+
+// Writes an iNES image to the temp directory and returns its path
+std::string writeRom(const std::string& name, const std::vector<u8>& prg,
+                     const std::vector<u8>& chr, u8 mapper)
+{
+    const auto path = std::filesystem::temp_directory_path() / ("vnes-bench-" + name + ".nes");
+    std::ofstream file(path, std::ios::binary);
+
+    u8 header[16] = {};
+    header[0] = 'N'; header[1] = 'E'; header[2] = 'S'; header[3] = 0x1A;
+    header[4] = static_cast<u8>(prg.size() / PRG_ROM_UNIT);
+    header[5] = static_cast<u8>(chr.size() / CHR_ROM_UNIT);
+    header[6] = static_cast<u8>(((mapper & 0x0F) << 4) | 0x01);  // vertical mirroring
+    header[7] = static_cast<u8>(mapper & 0xF0);
+
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(prg.data()), prg.size());
+    file.write(reinterpret_cast<const char*>(chr.data()), chr.size());
+    return path.string();
+}
+
+// Deterministic non-trivial tile data so every pixel path gets exercised
+std::vector<u8> makeChr(u32 size)
+{
+    std::vector<u8> chr(size);
+    u32 seed = 0x12345678;
+    for (auto& b : chr) {
+        seed = seed * 1664525u + 1013904223u;
+        b = static_cast<u8>(seed >> 24);
+    }
+    return chr;
+}
+
+std::vector<u8> makePrg32k(const u8* code, size_t length, u16 nmi, u16 irq)
+{
+    std::vector<u8> prg(2 * PRG_ROM_UNIT, 0xEA);
+    std::memcpy(prg.data(), code, length);
+
+    const u16 vectors[3] = { nmi, RESET_VECTOR, irq };
+    for (int i = 0; i < 3; i++) {
+        prg[0x7FFA + i * 2] = static_cast<u8>(vectors[i] & 0xFF);
+        prg[0x7FFB + i * 2] = static_cast<u8>(vectors[i] >> 8);
+    }
+    return prg;
+}
+
+std::vector<u8> makeStreamPrg(const std::vector<u8>& pattern)
+{
+    std::vector<u8> code;
+    while (code.size() + pattern.size() + 3 < 0x7FF0) {
+        code.insert(code.end(), pattern.begin(), pattern.end());
+    }
+    code.push_back(0x4C);  // JMP $8000
+    code.push_back(RESET_VECTOR & 0xFF);
+    code.push_back(RESET_VECTOR >> 8);
+    return makePrg32k(code.data(), code.size(), RESET_VECTOR, RESET_VECTOR);
+}
+
+std::string renderRomPath()
+{
+    static const std::string path = writeRom("render",
+        makePrg32k(renderProgram, sizeof(renderProgram), RENDER_NMI, RENDER_IRQ),
+        makeChr(CHR_ROM_UNIT), 0);
+    return path;
+}
+
+// Bus with the render ROM loaded and a few frames run so rendering is on
+std::unique_ptr<Bus> makeRenderingBus()
+{
+    auto bus = std::make_unique<Bus>();
+    if (!bus->loadCartridge(renderRomPath())) return nullptr;
+    bus->reset();
+    for (int i = 0; i < 4; i++) {
+        bus->runFrame();
+    }
+    return bus;
+}
+
+void benchCpuStream(bench::State& state, const std::vector<u8>& pattern, const std::string& name)
+{
+    auto bus = std::make_unique<Bus>();
+    if (!bus->loadCartridge(writeRom("cpu-" + name, makeStreamPrg(pattern), makeChr(CHR_ROM_UNIT), 0))) {
+        state.skipWithError("cannot load the generated CPU test ROM");
+        return;
+    }
+    bus->reset();
+
+    const int STEPS = 1000;
+    const u64 start_cycles = bus->cpu.getCycles();
+    while (state.keepRunning()) {
+        for (int i = 0; i < STEPS; i++) {
+            bus->cpu.step();
+        }
+    }
+    state.setItemsPerIteration(STEPS);
+    state.setCounter("cycles_per_instr",
+        static_cast<double>(bus->cpu.getCycles() - start_cycles) / (static_cast<double>(state.getIterations()) * STEPS));
+}
+
+void benchPpuFrame(bench::State& state)
+{
+    auto bus = makeRenderingBus();
+    if (!bus) {
+        state.skipWithError("cannot load the generated render ROM");
+        return;
+    }
+
+    const u32 DOTS_PER_FRAME = 341 * 262;
+    while (state.keepRunning()) {
+        bus->ppu.run(DOTS_PER_FRAME);
+    }
+    state.setItemsPerIteration(DOTS_PER_FRAME);
+}
+
+void benchApu(bench::State& state)
+{
+    auto bus = std::make_unique<Bus>();
+    APU& apu = bus->apu;
+    apu.reset();
+
+    // All four tone channels active with non-trivial settings
+    const std::pair<u16, u8> regs[] = {
+        { 0x4015, 0x0F },
+        { 0x4000, 0xBF }, { 0x4002, 0x80 }, { 0x4003, 0x02 },
+        { 0x4004, 0x7F }, { 0x4005, 0x8A }, { 0x4006, 0xC0 }, { 0x4007, 0x01 },
+        { 0x4008, 0xFF }, { 0x400A, 0x40 }, { 0x400B, 0x01 },
+        { 0x400C, 0x3A }, { 0x400E, 0x04 }, { 0x400F, 0x08 },
+    };
+    for (const auto& reg : regs) {
+        apu.writeRegister(reg.first, reg.second);
+    }
+
+    // Sums the synthesized samples so they are not optimized away
+    struct SumSink : AudioSink {
+        float sum = 0.0f;
+        void pushSamples(const float* samples, size_t count) override {
+            for (size_t i = 0; i < count; i++) sum += samples[i];
+        }
+    } sink;
+    apu.setAudioSink(&sink);
+
+    // One frame of cycles per iteration, then one synthesis pass
+    const int CYCLES = 29781;
+    while (state.keepRunning()) {
+        for (int i = 0; i < CYCLES; i++) {
+            apu.step();
+        }
+        apu.flushSamples();
+    }
+    apu.setAudioSink(nullptr);
+    bench::doNotOptimize(sink.sum);
+    state.setItemsPerIteration(CYCLES);
+}
+
+void benchToArgb(bench::State& state)
+{
+    auto bus = makeRenderingBus();
+    if (!bus) {
+        state.skipWithError("cannot load the generated render ROM");
+        return;
+    }
+
+    std::vector<u32> output(NES_WIDTH * NES_HEIGHT);
+    while (state.keepRunning()) {
+        PPU::toARGB(bus->ppu.getFramebuffer(), output.data(), output.size());
+        bench::doNotOptimize(output[0]);
+    }
+    state.setItemsPerIteration(NES_WIDTH * NES_HEIGHT);
+}
+
+void benchHq2x(bench::State& state)
+{
+    auto bus = makeRenderingBus();
+    if (!bus) {
+        state.skipWithError("cannot load the generated render ROM");
+        return;
+    }
+
+    HQ2x scaler;
+    std::vector<u32> input(NES_WIDTH * NES_HEIGHT);
+    std::vector<u32> output(NES_WIDTH * NES_HEIGHT * 4);
+    PPU::toARGB(bus->ppu.getFramebuffer(), input.data(), input.size());
+    while (state.keepRunning()) {
+        scaler.resize(input.data(), NES_WIDTH, NES_HEIGHT, output.data());
+        bench::doNotOptimize(output[0]);
+    }
+    state.setItemsPerIteration(NES_WIDTH * NES_HEIGHT);
+}
+
+void benchHq2xIndexed(bench::State& state, unsigned threads)
+{
+    auto bus = makeRenderingBus();
+    if (!bus) {
+        state.skipWithError("cannot load the generated render ROM");
+        return;
+    }
+
+    HQ2x scaler;
+    scaler.setThreadCount(threads);
+    std::vector<u32> output(NES_WIDTH * NES_HEIGHT * 4);
+    while (state.keepRunning()) {
+        scaler.resizeIndexed(bus->ppu.getFramebuffer(), PPU::getArgbTable(), NES_COLOR_COUNT,
+                             NES_WIDTH, NES_HEIGHT, output.data());
+        bench::doNotOptimize(output[0]);
+    }
+    state.setItemsPerIteration(NES_WIDTH * NES_HEIGHT);
+}
+
+struct MapperSetup {
+    u8 number;
+    u32 prg_size;
+    u32 chr_size;   // 0 = 8KB CHR RAM
+};
+
+void benchMapper(bench::State& state, const MapperSetup& setup, bool chr)
+{
+    auto mapper = MapperFactory::create(setup.number);
+    if (!mapper) {
+        state.skipWithError("no mapper " + std::to_string(setup.number));
+        return;
+    }
+
+    std::vector<u8> prg = makeChr(setup.prg_size);
+    std::vector<u8> chrData = setup.chr_size ? makeChr(setup.chr_size) : std::vector<u8>(CHR_ROM_UNIT);
+    std::vector<u8> prgRam(PRG_BANK_8K);
+    mapper->init(prg, chrData, prgRam, Mirroring::VERTICAL);
+
+    const u32 READS = 4096;
+    u32 sum = 0;
+    if (chr) {
+        while (state.keepRunning()) {
+            for (u32 i = 0; i < READS; i++) {
+                sum += mapper->readChr(static_cast<u16>((i * 7) & 0x1FFF));
+            }
+        }
+    }
+    else {
+        while (state.keepRunning()) {
+            for (u32 i = 0; i < READS; i++) {
+                sum += mapper->readPrg(static_cast<u16>(0x8000 | ((i * 7) & 0x7FFF)));
+            }
+        }
+    }
+    bench::doNotOptimize(sum);
+    state.setItemsPerIteration(READS);
+}
+
+void benchHeadless(bench::State& state, const std::string& rom, u64 frames)
+{
+    u64 cycles = 0;
+    while (state.keepRunning()) {
+        auto bus = std::make_unique<Bus>();
+        if (!bus->loadCartridge(rom)) {
+            state.skipWithError("cannot load ROM: " + rom);
+            return;
+        }
+        bus->reset();
+        for (u64 frame = 0; frame < frames; frame++) {
+            bus->updateInput(0);
+            bus->runFrame();
+            bus->cartridge.signalFrameComplete();
+        }
+        cycles = bus->cpu.getCycles();
+    }
+    state.setItemsPerIteration(frames);
+    state.setCounter("frames", static_cast<double>(frames));
+    state.setCounter("cpu_cycles", static_cast<double>(cycles));
+}
+
+void printUsage(const char* program)
+{
+    std::cout << "VNES - Benchmark suite" << std::endl;
+    std::cout << "Usage: " << program << " [options]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --json FILE        Write Google Benchmark style JSON results to FILE" << std::endl;
+    std::cout << "  --filter TEXT      Only run benchmarks whose name contains TEXT" << std::endl;
+    std::cout << "  --min-time SEC     Minimum run time per micro benchmark (default 0.5)" << std::endl;
+    std::cout << "  --frames N         Frames per macro benchmark run (default 10000)" << std::endl;
+    std::cout << "  --rom FILE         Also run the macro benchmark on FILE" << std::endl;
+    std::cout << "  --verify           Check the HQ2x fast paths against the plain one and exit" << std::endl;
+    std::cout << "  -h, --help         Show this help" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::string json_file;
+    std::string rom_file;
+    u64 frames = 10000;
+    bool verify = false;
+    bench::Runner runner;
+
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        }
+        else if (strcmp(argv[i], "--json") == 0 && hasValue) {
+            json_file = argv[++i];
+        }
+        else if (strcmp(argv[i], "--filter") == 0 && hasValue) {
+            runner.setFilter(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--min-time") == 0 && hasValue) {
+            runner.setMinTime(std::atof(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--frames") == 0 && hasValue) {
+            auto parsed = vnes::util::parseInteger(argv[++i]);
+            if (!parsed || *parsed == 0) {
+                std::cerr << "Invalid frame count: " << argv[i] << std::endl;
+                return 1;
+            }
+            frames = *parsed;
+        }
+        else if (strcmp(argv[i], "--rom") == 0 && hasValue) {
+            rom_file = argv[++i];
+        }
+        else if (strcmp(argv[i], "--verify") == 0) {
+            verify = true;
+        }
+        else {
+            std::cerr << "Unknown option: " << argv[i] << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (verify) {
+        if (!bench::verifyScaler()) {
+            std::cerr << "Scaler self-check failed" << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // Micro: CPU instruction dispatch
+    runner.add("CPU/step/alu", [](bench::State& s) { benchCpuStream(s, aluPattern, "alu"); });
+    runner.add("CPU/step/memory", [](bench::State& s) { benchCpuStream(s, memoryPattern, "memory"); });
+    runner.add("CPU/step/rmw", [](bench::State& s) { benchCpuStream(s, rmwPattern, "rmw"); });
+    runner.add("CPU/step/branch", [](bench::State& s) { benchCpuStream(s, branchPattern, "branch"); });
+
+    // Micro: PPU, APU, scaler
+    runner.add("PPU/step/frame", benchPpuFrame);
+    runner.add("PPU/toARGB/256x240", benchToArgb);
+    runner.add("APU/frame+synthesis", benchApu);
+    runner.add("HQ2x/resize/256x240", benchHq2x);
+    runner.add("HQ2x/resizeIndexed/256x240", [](bench::State& state) { benchHq2xIndexed(state, 1); });
+    runner.add("HQ2x/resizeIndexed/256x240/threads:4", [](bench::State& state) { benchHq2xIndexed(state, 4); });
+
+    // Micro: mapper bank lookups
+    const MapperSetup mappers[] = {
+        { 0, 2 * PRG_ROM_UNIT, CHR_ROM_UNIT },
+        { 1, 16 * PRG_ROM_UNIT, 16 * CHR_ROM_UNIT },
+        { 2, 16 * PRG_ROM_UNIT, 0 },
+        { 4, 16 * PRG_ROM_UNIT, 32 * CHR_ROM_UNIT },
+        { 9, 8 * PRG_ROM_UNIT, 16 * CHR_ROM_UNIT },
+    };
+    for (const auto& setup : mappers) {
+        const std::string prefix = "Mapper" + vnes::util::toHex(setup.number, 3);
+        runner.add(prefix + "/readPrg", [setup](bench::State& s) { benchMapper(s, setup, false); });
+        runner.add(prefix + "/readChr", [setup](bench::State& s) { benchMapper(s, setup, true); });
+    }
+
+    // Macro: whole-system headless runs
+    runner.add("Headless/render_rom/" + std::to_string(frames) + "_frames",
+               [frames](bench::State& s) { benchHeadless(s, renderRomPath(), frames); }, 1);
+    if (!rom_file.empty()) {
+        const std::string name = std::filesystem::path(rom_file).filename().string();
+        runner.add("Headless/" + name + "/" + std::to_string(frames) + "_frames",
+                   [rom_file, frames](bench::State& s) { benchHeadless(s, rom_file, frames); }, 1);
+    }
+
+    // Cartridge::load reports every ROM on stdout; keep the results readable
+    std::ostringstream discard;
+    std::streambuf* cout_buf = std::cout.rdbuf(discard.rdbuf());
+    runner.runAll();
+    std::cout.rdbuf(cout_buf);
+
+    runner.printTable();
+
+    if (!json_file.empty()) {
+        if (!runner.writeJson(json_file)) {
+            std::cerr << "Cannot write JSON output: " << json_file << std::endl;
+            return 1;
+        }
+        std::cout << "Results written to " << json_file << std::endl;
+    }
+
+    if (runner.hasErrors()) {
+        std::cerr << "Some benchmarks failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,258 @@
+#include "verify.h"
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "hq2x.h"
+#include "ppu.h"
+
+namespace bench {
+
+namespace {
+
+struct Size {
+    u32 width;
+    u32 height;
+};
+
+// Edge cases for the banding and the kernels' blocks of 4/8 columns, then a
+// whole NES frame
+const Size sizes[] = {
+    { 1, 1 }, { 2, 1 }, { 1, 2 }, { 3, 3 }, { 5, 4 }, { 9, 7 }, { 17, 3 }, { 31, 13 },
+    { NES_WIDTH, NES_HEIGHT },
+};
+
+struct Thresholds {
+    u32 y, u, v, a;
+    const char* name;
+};
+
+const Thresholds thresholds[] = {
+    { 0x30, 0x07, 0x06, 0x50, "default" },
+    { 0x00, 0x00, 0x00, 0x00, "zero" },
+    { 0x30, static_cast<u32>(-1), 0x06, 0x50, "always" },   // negative: all differ
+};
+
+const unsigned threadCounts[] = { 1, 2, 3, 7 };
+
+// Paletted images with a few colours, at most 64 (the dense path) and more
+const u32 paletteColors[] = { 4, 48, 200 };
+
+struct Image {
+    std::string name;
+    u32 width;
+    u32 height;
+    const std::vector<u32>* palette;   // null for plain ARGB images
+    std::vector<u16> indices;
+    std::vector<u32> argb;
+};
+
+u32 swapRedBlue(u32 color)
+{
+    return (color & 0xFF00FF00) | ((color >> 16) & 0xFF) | ((color & 0xFF) << 16);
+}
+
+// Moves every channel by a few steps, so neighbours straddle the thresholds
+u32 nudge(std::mt19937& rng, u32 color)
+{
+    u32 result = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        int channel = static_cast<int>((color >> shift) & 0xFF) + static_cast<int>(rng() % 25) - 12;
+        channel = channel < 0 ? 0 : (channel > 0xFF ? 0xFF : channel);
+        result |= static_cast<u32>(channel) << shift;
+    }
+    return result;
+}
+
+// Random colours with runs, repeats from the row above and near misses
+Image makeRandomImage(std::mt19937& rng, u32 width, u32 height)
+{
+    Image image{ "random", width, height, nullptr, {}, std::vector<u32>(width * height) };
+    for (u32 y = 0; y < height; y++) {
+        for (u32 x = 0; x < width; x++) {
+            const u32 left = x > 0 ? image.argb[y * width + x - 1] : rng();
+            const u32 above = y > 0 ? image.argb[(y - 1) * width + x] : rng();
+            u32 color;
+            switch (rng() % 8) {
+                case 0: case 1: case 2: color = rng(); break;
+                case 3: case 4: color = left; break;
+                case 5: color = above; break;
+                default: color = nudge(rng, left); break;
+            }
+            image.argb[y * width + x] = color;
+        }
+    }
+    return image;
+}
+
+// Indices into `colors` entries of the palette, with runs and repeats
+Image makePaletteImage(std::mt19937& rng, const std::string& name, const std::vector<u32>& palette,
+                       u32 colors, u32 width, u32 height)
+{
+    std::vector<u16> subset(colors);
+    for (u16& index : subset) {
+        index = static_cast<u16>(rng() % palette.size());
+    }
+
+    Image image{ name + "/" + std::to_string(colors), width, height, &palette,
+                 std::vector<u16>(width * height), std::vector<u32>(width * height) };
+    for (u32 y = 0; y < height; y++) {
+        for (u32 x = 0; x < width; x++) {
+            u16 index;
+            const u32 pick = rng() % 10;
+            if (pick < 5 && x > 0) {
+                index = image.indices[y * width + x - 1];
+            }
+            else if (pick < 7 && y > 0) {
+                index = image.indices[(y - 1) * width + x];
+            }
+            else {
+                index = subset[rng() % colors];
+            }
+            image.indices[y * width + x] = index;
+            image.argb[y * width + x] = palette[index];
+        }
+    }
+    return image;
+}
+
+// Random colours including exact duplicates (equal colours at different
+// indices) and near misses
+std::vector<u32> makeRandomPalette(std::mt19937& rng)
+{
+    std::vector<u32> palette(256);
+    for (size_t i = 0; i < palette.size(); i++) {
+        switch (i > 0 ? rng() % 4 : 0) {
+            case 0: case 1: palette[i] = rng(); break;
+            case 2: palette[i] = palette[rng() % i]; break;
+            default: palette[i] = nudge(rng, palette[rng() % i]); break;
+        }
+    }
+    return palette;
+}
+
+// Reports the first differing pixel; returns true when the images match
+bool matches(const std::vector<u32>& expected, const std::vector<u32>& actual, u32 width,
+             const std::string& what)
+{
+    for (size_t i = 0; i < expected.size(); i++) {
+        if (expected[i] != actual[i]) {
+            char pixel[96];
+            std::snprintf(pixel, sizeof(pixel), "pixel (%u, %u): expected %08X, got %08X",
+                          static_cast<unsigned>(i % width), static_cast<unsigned>(i / width),
+                          expected[i], actual[i]);
+            std::cerr << "MISMATCH " << what << ": " << pixel << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool verifyScaler()
+{
+    const std::vector<const char*> kernels = HQx::getKernelNames();
+    std::cout << "HQ2x kernels:";
+    for (const char* kernel : kernels) {
+        std::cout << " " << kernel;
+    }
+    std::cout << std::endl;
+
+    std::mt19937 rng(0x5EED);
+    const std::vector<u32> nesPalette(PPU::getArgbTable(), PPU::getArgbTable() + NES_COLOR_COUNT);
+    const std::vector<u32> randomPalette = makeRandomPalette(rng);
+    std::vector<u32> nesRgba(nesPalette.size());
+    std::vector<u32> randomRgba(randomPalette.size());
+    for (size_t i = 0; i < nesPalette.size(); i++) nesRgba[i] = swapRedBlue(nesPalette[i]);
+    for (size_t i = 0; i < randomPalette.size(); i++) randomRgba[i] = swapRedBlue(randomPalette[i]);
+
+    std::vector<Image> images;
+    for (const Size& size : sizes) {
+        images.push_back(makeRandomImage(rng, size.width, size.height));
+        for (u32 colors : paletteColors) {
+            images.push_back(makePaletteImage(rng, "nes", nesPalette, colors, size.width, size.height));
+            images.push_back(makePaletteImage(rng, "palette", randomPalette, colors, size.width, size.height));
+        }
+    }
+
+    // Kept across cases, like the display's, so the palette table cache
+    // sees palette and threshold changes
+    HQ2x reference;
+    std::vector<std::unique_ptr<HQ2x>> scalers;
+    std::vector<std::unique_ptr<HQ2x>> rgbaScalers;
+    for (unsigned threads : threadCounts) {
+        scalers.push_back(std::make_unique<HQ2x>());
+        scalers.back()->setThreadCount(threads);
+        rgbaScalers.push_back(std::make_unique<HQ2x>());
+        rgbaScalers.back()->setThreadCount(threads);
+        rgbaScalers.back()->setRgbaPalette(true);
+    }
+
+    u64 checks = 0;
+    u64 failures = 0;
+    auto check = [&](const std::vector<u32>& expected, const std::vector<u32>& actual, u32 width,
+                     const std::string& what) {
+        checks++;
+        if (!matches(expected, actual, width, what)) failures++;
+    };
+
+    for (const Image& image : images) {
+        const u32 outWidth = image.width * 2;
+        const size_t outPixels = static_cast<size_t>(outWidth) * image.height * 2;
+        std::vector<u32> expected(outPixels);
+        std::vector<u32> expectedRgba(outPixels);
+        std::vector<u32> actual(outPixels);
+
+        for (int wrap = 0; wrap < 4; wrap++) {
+            const bool wrapX = (wrap & 1) != 0;
+            const bool wrapY = (wrap & 2) != 0;
+            for (const Thresholds& t : thresholds) {
+                const std::string name = image.name + " " + std::to_string(image.width) + "x" +
+                    std::to_string(image.height) + " wrap:" + (wrapX ? "x" : "-") + (wrapY ? "y" : "-") +
+                    " thresholds:" + t.name;
+
+                HQx::setKernel("scalar");
+                reference.resize(image.argb.data(), image.width, image.height, expected.data(),
+                                 t.y, t.u, t.v, t.a, wrapX, wrapY);
+
+                for (const char* kernel : kernels) {
+                    HQx::setKernel(kernel);
+                    for (size_t i = 0; i < scalers.size(); i++) {
+                        scalers[i]->resize(image.argb.data(), image.width, image.height, actual.data(),
+                                           t.y, t.u, t.v, t.a, wrapX, wrapY);
+                        check(expected, actual, outWidth, name + " resize kernel:" + kernel +
+                              " threads:" + std::to_string(threadCounts[i]));
+                    }
+                }
+
+                if (!image.palette) continue;
+
+                const std::vector<u32>& palette = *image.palette;
+                const std::vector<u32>& rgba = image.palette == &nesPalette ? nesRgba : randomRgba;
+                for (size_t i = 0; i < outPixels; i++) expectedRgba[i] = swapRedBlue(expected[i]);
+
+                for (size_t i = 0; i < scalers.size(); i++) {
+                    const std::string threads = " threads:" + std::to_string(threadCounts[i]);
+                    scalers[i]->resizeIndexed(image.indices.data(), palette.data(), static_cast<u32>(palette.size()),
+                                              image.width, image.height, actual.data(),
+                                              t.y, t.u, t.v, t.a, wrapX, wrapY);
+                    check(expected, actual, outWidth, name + " resizeIndexed" + threads);
+
+                    rgbaScalers[i]->resizeIndexed(image.indices.data(), rgba.data(), static_cast<u32>(rgba.size()),
+                                                  image.width, image.height, actual.data(),
+                                                  t.y, t.u, t.v, t.a, wrapX, wrapY);
+                    check(expectedRgba, actual, outWidth, name + " resizeIndexed/rgba" + threads);
+                }
+            }
+        }
+    }
+    HQx::setKernel(kernels.front());
+
+    std::cout << checks << " checks, " << failures << " mismatches" << std::endl;
+    return failures == 0;
+}
+
+} // namespace bench
@@ -0,0 +1,18 @@
+#ifndef BENCH_VERIFY_H
+#define BENCH_VERIFY_H
+
+// Scaler self-check, run by `vnes-bench --verify` and `make check`. The
+// fast HQ2x paths must match the plain one bit for bit: resize() with every
+// pattern kernel this CPU can run against the scalar kernel,
+// resizeIndexed() against resize() on the expanded image, and 1 against N
+// threads, over random and palette-like images of odd sizes, both wrap
+// modes and several thresholds.
+
+namespace bench {
+
+// Returns true when every check passed; mismatches are reported on stderr
+bool verifyScaler();
+
+} // namespace bench
+
+#endif // BENCH_VERIFY_H
@@ -1,6 +1,7 @@
 #include "apu.h"
-#include "sound.h"
 #include "bus.h"
+#include "savestate.h"
+#include <algorithm>
 
 // Length counter lookup table
 static const u8 length_table[32] = {
@@ -34,10 +35,8 @@ const u8 APU::duty_table[4][8] = {
 };
 
 APU::APU(Bus& b)
-    : bus(b)
-    , frame_counter_mode(0), irq_inhibit(false), irq_flag(false)
-    , frame_counter(0), cycles(0), sample_accumulator(0.0f)
-    , samples_this_frame(0), sound()
+    : frame_counter_mode(0), irq_inhibit(false), irq_flag(false)
+    , frame_counter(0), cycles(0), bus(b)
 {
     // Initialize pulse channels
     for (int i = 0; i < 2; i++) {
@@ -102,6 +101,8 @@ APU::APU(Bus& b)
     dmc.sample_buffer = 0;
     dmc.sample_buffer_empty = true;
     dmc.enabled = false;
+
+    setSampleRate(DEFAULT_SAMPLE_RATE);
 }
 
 void APU::reset()
@@ -110,14 +111,7 @@ void APU::reset()
     writeRegister(0x4017, 0);
     cycles = 0;
     frame_counter = 0;
-    sample_accumulator = 0.0f;
-    samples_this_frame = 0;
-
-    // start the sound system if not already started
-    if(!sound.initialized) {
-        sound.initialized = true;
-        sound.start();
-    }
+    output_dirty = true;
 }
 
 void APU::clockTimers()
@@ -127,6 +121,7 @@ void APU::clockTimers()
         if (pulse[i].timer == 0) {
             pulse[i].timer = pulse[i].timer_period;
             pulse[i].sequence_pos = (pulse[i].sequence_pos + 1) & 0x07;
+            output_dirty = true;
         } else {
             pulse[i].timer--;
         }
@@ -139,6 +134,7 @@ void APU::clockTimers()
         u8 feedback_bit = noise.mode ? 6 : 1;
         u16 feedback = (noise.shift_register & 1) ^ ((noise.shift_register >> feedback_bit) & 1);
         noise.shift_register = (noise.shift_register >> 1) | (feedback << 14);
+        output_dirty = true;
     } else {
         noise.timer--;
     }
@@ -151,6 +147,7 @@ void APU::clockTriangleTimer()
         triangle.timer = triangle.timer_period;
         if (triangle.length_counter > 0 && triangle.linear_counter > 0) {
             triangle.sequence_pos = (triangle.sequence_pos + 1) & 0x1F;
+            output_dirty = true;
         }
     } else {
         triangle.timer--;
@@ -159,6 +156,8 @@ void APU::clockTriangleTimer()
 
 void APU::clockLengthCounters()
 {
+    output_dirty = true;
+
     // Pulse channels
     for (int i = 0; i < 2; i++) {
         if (!pulse[i].length_halt && pulse[i].length_counter > 0) {
@@ -179,6 +178,8 @@ void APU::clockLengthCounters()
 
 void APU::clockSweeps()
 {
+    output_dirty = true;
+
     for (int i = 0; i < 2; i++) {
         Pulse& p = pulse[i];
         if (p.sweep_counter == 0) {
@@ -205,6 +206,8 @@ void APU::clockSweeps()
 
 void APU::clockEnvelopes()
 {
+    output_dirty = true;
+
     // Pulse channels
     for (int i = 0; i < 2; i++) {
         if (pulse[i].envelope_start) {
@@ -246,6 +249,8 @@ void APU::clockEnvelopes()
 
 void APU::clockTriangleLinear()
 {
+    output_dirty = true;
+
     if (triangle.linear_reload_flag) {
         triangle.linear_counter = triangle.linear_reload;
     } else if (triangle.linear_counter > 0) {
@@ -296,12 +301,111 @@ void APU::clockDMC()
             }
             dmc.shift_register >>= 1;
             dmc.bits_remaining--;
+            output_dirty = true;
         }
     } else {
         dmc.timer--;
     }
 }
 
+void APU::serialize(StateStream& s)
+{
+    s.io(pulse);
+    s.io(triangle);
+    s.io(noise);
+    s.io(dmc);
+    s.io(frame_counter_mode);
+    s.io(irq_inhibit);
+    s.io(irq_flag);
+    s.io(frame_counter);
+    s.io(cycles);
+    output_dirty = true;
+}
+
+void APU::run(u32 cpu_cycles)
+{
+    while (cpu_cycles > 0) {
+        const u32 quiet = std::min(cpu_cycles, cyclesToNextEvent() - 1);
+        skipCycles(quiet);
+        cpu_cycles -= quiet;
+        if (cpu_cycles > 0) {
+            step();
+            cpu_cycles--;
+        }
+    }
+}
+
+// Frame counter steps (the value frame_counter reaches on that cycle)
+static const u32 frame_steps[2][4] = {
+    { 3729, 7457, 11186, 14915 },   // 4-step
+    { 3729, 7457, 11186, 18641 },   // 5-step
+};
+
+u32 APU::cyclesToNextEvent() const
+{
+    // A pending level change is timestamped on the next cycle
+    if (output_dirty && sink) {
+        return 1;
+    }
+
+    // Triangle and DMC timers count every cycle; pulse and noise timers on
+    // even cycles only. A timer does something on the cycle it is at 0.
+    u32 next = triangle.timer + 1u;
+    if (dmc.enabled) {
+        const bool fetch = dmc.sample_buffer_empty && dmc.bytes_remaining > 0;
+        next = std::min(next, fetch ? 1u : dmc.timer + 1u);
+    }
+    const u32 first_even = (cycles & 1) ? 1 : 2;
+    const u16 timer = std::min({ pulse[0].timer, pulse[1].timer, noise.timer });
+    next = std::min(next, first_even + 2u * timer);
+
+    u32 frame_step = frame_counter + 1;
+    for (u32 value : frame_steps[frame_counter_mode]) {
+        if (value > frame_counter) {
+            frame_step = value;
+            break;
+        }
+    }
+    next = std::min(next, frame_step - frame_counter);
+
+    return std::min(next, MAX_FRAME_CYCLES - frame_cycles);
+}
+
+void APU::skipCycles(u32 count)
+{
+    // Only valid below cyclesToNextEvent(): every timer stays above 0
+    const u16 even_cycles = static_cast<u16>((cycles + count) / 2 - cycles / 2);
+    cycles += count;
+    frame_counter += count;
+    frame_cycles += count;
+
+    triangle.timer -= static_cast<u16>(count);
+    if (dmc.enabled) {
+        dmc.timer -= static_cast<u16>(count);
+    }
+    pulse[0].timer -= even_cycles;
+    pulse[1].timer -= even_cycles;
+    noise.timer -= even_cycles;
+}
+
+u32 APU::cyclesUntilIrq() const
+{
+    u32 until = NO_IRQ;
+    if (frame_counter_mode == 0 && !irq_inhibit) {
+        until = frame_steps[0][3] - frame_counter;
+    }
+
+    // The DMC raises its IRQ when it fetches the last byte. The buffer and
+    // shift register may hold up to two bytes' worth; every byte after
+    // that takes 8 timer periods to play
+    if (dmc.enabled && dmc.irq_enable && !dmc.loop && dmc.bytes_remaining > 0) {
+        const u32 period = dmc_rate_table[dmc.rate] + 1u;
+        const u32 bytes = dmc.bytes_remaining;
+        until = std::min(until, bytes > 2 ? (bytes - 2) * 8 * period : 1u);
+    }
+    return until;
+}
+
 void APU::step()
 {
     cycles++;
@@ -358,15 +462,89 @@ void APU::step()
         }
     }
     
-    // Sample generation - output a sample at 44.1kHz rate
-    sample_accumulator += 1.0f;
-    if (sample_accumulator >= CYCLES_PER_SAMPLE) {
-        sample_accumulator -= CYCLES_PER_SAMPLE;
-        sound.pushSample(getOutput());
+    // Sample generation - only level changes cost anything here
+    if (output_dirty && sink) {
+        updateOutput();
+    }
+    if (++frame_cycles == MAX_FRAME_CYCLES) {
+        flushSamples();
     }
 }
 
+void APU::updateOutput()
+{
+    output_dirty = false;
+
+    // Mix each group only when its inputs changed
+    const int pulses = pulseLevel(0) + pulseLevel(1);
+    const int triangle_level = triangleLevel();
+    const int noise_level = noiseLevel();
+    const int tnd = triangle_level | (noise_level << 4) | (dmc.output << 8);
+    if (pulses == pulse_sum && tnd == tnd_levels) {
+        return;
+    }
+    if (pulses != pulse_sum) {
+        pulse_sum = pulses;
+        pulse_out = mixPulse(pulses);
+    }
+    if (tnd != tnd_levels) {
+        tnd_levels = tnd;
+        tnd_out = mixTnd(triangle_level, noise_level, dmc.output);
+    }
+
+    const float level = (pulse_out + tnd_out) * 2.0f - 1.0f;
+    blip.addDelta(frame_cycles, level - output_level);
+    output_level = level;
+}
+
+void APU::flushSamples()
+{
+    // Without a sink no steps were added: the time is left out of the audio
+    // (muted rewind or run-ahead frames) and synthesis resumes where it was
+    if (!sink) {
+        frame_cycles = 0;
+        return;
+    }
+
+    blip.endFrame(frame_cycles);
+    frame_cycles = 0;
+
+    const size_t count = blip.readSamples(sample_block.data(), sample_block.size());
+    if (count > 0) {
+        sink->pushSamples(sample_block.data(), count);
+    }
+
+    // Dynamic rate control: the next frame is resampled at the sink's ratio
+    blip.setRateScale(sink->nextRateScale());
+}
+
+void APU::setSampleRate(unsigned rate)
+{
+    if (!sample_block.empty()) {
+        flushSamples();
+    }
+    blip.setRates(CPU_CLOCK_RATE, rate, MAX_FRAME_CYCLES);
+    sample_block.resize(blip.getMaxSamples());
+
+    // The synthesizer restarts from silence
+    pulse_sum = -1;
+    tnd_levels = -1;
+    output_level = 0.0f;
+    output_dirty = true;
+}
+
 u8 APU::readRegister(u16 addr)
+{
+    u8 data = peekRegister(addr);
+
+    if (addr == 0x4015) {
+        irq_flag = false;  // Clear frame IRQ flag on read
+    }
+
+    return data;
+}
+
+u8 APU::peekRegister(u16 addr) const
 {
     u8 data = 0;
 
@@ -379,8 +557,6 @@ u8 APU::readRegister(u16 addr)
         if (dmc.bytes_remaining > 0)     data |= 0x10;
         if (irq_flag)                    data |= 0x40;
         if (dmc.irq_flag)                data |= 0x80;
-        
-        irq_flag = false;  // Clear frame IRQ flag on read
     }
 
     return data;
@@ -388,6 +564,8 @@ u8 APU::readRegister(u16 addr)
 
 void APU::writeRegister(u16 addr, u8 data)
 {
+    output_dirty = true;
+
     switch (addr) {
         // Pulse 1
         case 0x4000:
@@ -530,65 +708,63 @@ void APU::writeRegister(u16 addr, u8 data)
     }
 }
 
-float APU::getOutput() const
+u8 APU::pulseLevel(int i) const
 {
-    // Generate actual waveform samples
-    
-    // Pulse 1
-    u8 pulse1_sample = 0;
-    if (pulse[0].enabled && pulse[0].length_counter > 0 && pulse[0].timer_period >= 8) {
-        u16 change = pulse[0].sweep_shift ? (pulse[0].timer_period >> pulse[0].sweep_shift) : 0;
-        u16 target = pulse[0].sweep_negate
-            ? (pulse[0].timer_period - change - 1)
-            : (pulse[0].timer_period + change);
-        if (!pulse[0].sweep_enabled || pulse[0].sweep_shift == 0 || target <= 0x7FF) {
-            u8 duty_out = duty_table[pulse[0].duty][pulse[0].sequence_pos];
-            u8 vol = pulse[0].constant_volume ? pulse[0].volume : pulse[0].envelope_volume;
-            pulse1_sample = duty_out ? vol : 0;
-        }
+    const Pulse& p = pulse[i];
+    if (!p.enabled || p.length_counter == 0 || p.timer_period < 8) {
+        return 0;
     }
-    
-    // Pulse 2
-    u8 pulse2_sample = 0;
-    if (pulse[1].enabled && pulse[1].length_counter > 0 && pulse[1].timer_period >= 8) {
-        u16 change = pulse[1].sweep_shift ? (pulse[1].timer_period >> pulse[1].sweep_shift) : 0;
-        u16 target = pulse[1].sweep_negate
-            ? (pulse[1].timer_period - change)
-            : (pulse[1].timer_period + change);
-        if (!pulse[1].sweep_enabled || pulse[1].sweep_shift == 0 || target <= 0x7FF) {
-            u8 duty_out = duty_table[pulse[1].duty][pulse[1].sequence_pos];
-            u8 vol = pulse[1].constant_volume ? pulse[1].volume : pulse[1].envelope_volume;
-            pulse2_sample = duty_out ? vol : 0;
-        }
+
+    // Muted while the sweep target overflows (pulse 1 negates with an
+    // extra -1)
+    u16 change = p.sweep_shift ? (p.timer_period >> p.sweep_shift) : 0;
+    u16 target = p.sweep_negate
+        ? (p.timer_period - change - (i == 0 ? 1 : 0))
+        : (p.timer_period + change);
+    if (p.sweep_enabled && p.sweep_shift != 0 && target > 0x7FF) {
+        return 0;
     }
-    
-    // Triangle
-    u8 triangle_sample = 0;
+
+    u8 duty_out = duty_table[p.duty][p.sequence_pos];
+    u8 vol = p.constant_volume ? p.volume : p.envelope_volume;
+    return duty_out ? vol : 0;
+}
+
+u8 APU::triangleLevel() const
+{
     if (triangle.enabled && triangle.length_counter > 0 && triangle.linear_counter > 0 && triangle.timer_period >= 2) {
-        triangle_sample = triangle_sequence[triangle.sequence_pos];
+        return triangle_sequence[triangle.sequence_pos];
     }
-    
-    // Noise
-    u8 noise_sample = 0;
+    return 0;
+}
+
+u8 APU::noiseLevel() const
+{
     if (noise.enabled && noise.length_counter > 0 && !(noise.shift_register & 1)) {
-        noise_sample = noise.constant_volume ? noise.volume : noise.envelope_volume;
-    }
-    
-    // DMC
-    u8 dmc_sample = dmc.output;
-    
-    // Mix using NES mixer formulas
-    float pulse_out = 0.0f;
-    float tnd_out = 0.0f;
-    
-    if (pulse1_sample || pulse2_sample) {
-        pulse_out = 95.88f / ((8128.0f / (pulse1_sample + pulse2_sample)) + 100.0f);
+        return noise.constant_volume ? noise.volume : noise.envelope_volume;
     }
-    
-    if (triangle_sample || noise_sample || dmc_sample) {
-        tnd_out = 159.79f / ((1.0f / ((triangle_sample / 8227.0f) + (noise_sample / 12241.0f) + (dmc_sample / 22638.0f))) + 100.0f);
+    return 0;
+}
+
+// NES mixer formulas
+float APU::mixPulse(int pulse_sum)
+{
+    return pulse_sum ? 95.88f / ((8128.0f / pulse_sum) + 100.0f) : 0.0f;
+}
+
+float APU::mixTnd(int triangle_level, int noise_level, int dmc_level)
+{
+    if (!triangle_level && !noise_level && !dmc_level) {
+        return 0.0f;
     }
-    
+    return 159.79f / ((1.0f / ((triangle_level / 8227.0f) + (noise_level / 12241.0f) + (dmc_level / 22638.0f))) + 100.0f);
+}
+
+float APU::getOutput() const
+{
+    float pulse_mix = mixPulse(pulseLevel(0) + pulseLevel(1));
+    float tnd_mix = mixTnd(triangleLevel(), noiseLevel(), dmc.output);
+
     // Return combined output (normalized to approximately -1.0 to 1.0)
-    return (pulse_out + tnd_out) * 2.0f - 1.0f;
+    return (pulse_mix + tnd_mix) * 2.0f - 1.0f;
 }
@@ -2,11 +2,13 @@
 #define APU_H
 
 #include "types.h"
-#include "sound.h"
+#include "audio_sink.h"
+#include "blip_buffer.h"
 #include <cstdint>
+#include <vector>
 
-class Sound;
 class Bus;
+class StateStream;
 
 class APU {
 public:
@@ -15,10 +17,25 @@ public:
     void reset();
     void step();
 
+    // Advance the APU by a batch of CPU cycles. Stretches in which no timer
+    // expires, no frame counter step is due and no DMC byte is fetched are
+    // skipped in bulk, so the cost follows the number of events
+    void run(u32 cpu_cycles);
+
+    // Lower bound on the CPU cycles until the frame counter or DMC could
+    // raise an IRQ (NO_IRQ if neither can); the bus catches the APU up by
+    // then so isIRQ() is seen on the same instruction as before
+    static const u32 NO_IRQ = 0xFFFFFFFF;
+    u32 cyclesUntilIrq() const;
+
     // CPU interface (registers $4000-$4017)
     u8 readRegister(u16 addr);
     void writeRegister(u16 addr, u8 data);
 
+    // What readRegister would return, without acknowledging the frame IRQ
+    // (for the debugger; reflects the APU as far as the bus has run it)
+    u8 peekRegister(u16 addr) const;
+
     // Frame counter IRQ
     bool isIRQ() const { return irq_flag || dmc.irq_flag; }
     void clearIRQ() { irq_flag = false; dmc.irq_flag = false; }
@@ -50,9 +67,25 @@ public:
     u8 getFrameCounterMode() const { return frame_counter_mode; }
     bool getIrqInhibit() const { return irq_inhibit; }
     
-    // Audio output
+    // Audio output: the mixer level at the current cycle
     float getOutput() const;
 
+    // Route generated samples to a frontend (nullptr = discard). Samples are
+    // synthesized per frame and handed over by flushSamples(), which
+    // Bus::runFrame calls at the end of every frame; the sink's
+    // nextRateScale() sets the resampling ratio of the frame after
+    void setAudioSink(AudioSink* s) { flushSamples(); sink = s; output_dirty = true; }
+    AudioSink* getAudioSink() const { return sink; }
+    void flushSamples();
+
+    // Output rate of the synthesized samples (default 44100 Hz)
+    void setSampleRate(unsigned rate);
+
+    // Save-state support: channels, frame counter, IRQ flags and cycle count.
+    // The synthesizer (blip buffer, frame_cycles) is not saved; after a load
+    // it restarts from the restored mixer level.
+    void serialize(StateStream& s);
+
 private:
     void clockTimers();
     void clockTriangleTimer();
@@ -61,6 +94,21 @@ private:
     void clockEnvelopes();
     void clockTriangleLinear();
     void clockDMC();
+
+    // Steps until the next cycle on which step() has more to do than count
+    // timers down (1 = the very next one), and the bulk skip up to it
+    u32 cyclesToNextEvent() const;
+    void skipCycles(u32 count);
+
+    // Channel outputs (0-15, DMC 0-127) as fed to the mixer
+    u8 pulseLevel(int i) const;
+    u8 triangleLevel() const;
+    u8 noiseLevel() const;
+    static float mixPulse(int pulse_sum);
+    static float mixTnd(int triangle_level, int noise_level, int dmc_level);
+
+    // Feed a mixer level change into the band-limited synthesizer
+    void updateOutput();
     
     // Pulse duty cycle sequences
     static const u8 duty_table[4][8];
@@ -143,14 +191,25 @@ private:
 
     u64 cycles;
 
-    // Sample generation
-    Sound sound;
+    // Sample generation: channels only report mixer level changes (set
+    // output_dirty), which become band-limited steps in `blip`; a frame's
+    // samples are integrated in one pass by flushSamples()
+    AudioSink* sink = nullptr;
     Bus& bus;
-    float sample_accumulator = 0.0f;
-    int samples_this_frame = 0;
-    static constexpr float CPU_CLOCK_RATE = 1789773.0f;
-    static constexpr float SAMPLE_RATE = 44100.0f;
-    static constexpr float CYCLES_PER_SAMPLE = CPU_CLOCK_RATE / SAMPLE_RATE;
+    BlipBuffer blip;
+    std::vector<float> sample_block;    // one frame of synthesized samples
+    u32 frame_cycles = 0;               // CPU cycles since the last flush
+    bool output_dirty = true;
+    int pulse_sum = -1;                 // mixer inputs at the last update
+    int tnd_levels = -1;
+    float pulse_out = 0.0f;
+    float tnd_out = 0.0f;
+    float output_level = 0.0f;          // level last fed to `blip`
+    static constexpr double CPU_CLOCK_RATE = 1789773.0;
+    static const unsigned DEFAULT_SAMPLE_RATE = 44100;
+    // A frame is ~29781 cycles; the block is flushed early when
+    // single-stepping runs past this
+    static const u32 MAX_FRAME_CYCLES = 32768;
 };
 
 #endif // APU_H
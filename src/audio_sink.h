@@ -0,0 +1,23 @@
+#ifndef AUDIO_SINK_H
+#define AUDIO_SINK_H
+
+#include <cstddef>
+
+// Destination for APU output samples.
+// Keeps the emulation core free of any audio backend: the SFML frontend
+// plugs in Sound, the headless runner plugs in a WAV writer (or nothing).
+class AudioSink {
+public:
+    virtual ~AudioSink() = default;
+
+    // Called from the emulation thread with a block of mixed samples in
+    // [-1, 1]; the APU hands over one block per frame
+    virtual void pushSamples(const float* samples, size_t count) = 0;
+
+    // Output rate stretch wanted for the next block (1 = nominal), asked
+    // after every pushSamples. A real-time device uses it to hold its buffer
+    // at a steady fill level despite clock drift; files keep the default.
+    virtual double nextRateScale() { return 1.0; }
+};
+
+#endif // AUDIO_SINK_H
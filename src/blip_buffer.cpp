@@ -0,0 +1,107 @@
+#include "blip_buffer.h"
+#include <algorithm>
+#include <cmath>
+
+BlipBuffer::BlipBuffer()
+    : base_factor(0)
+    , factor(0)
+    , offset(0)
+    , available(0)
+    , max_samples(0)
+    , integrator(0.0)
+{
+    buildKernel();
+}
+
+void BlipBuffer::buildKernel()
+{
+    // Lowpass just under Nyquist, Blackman-windowed over the kernel
+    const double PI = 3.14159265358979323846;
+    const double CUTOFF = 0.90;
+    const double HALF = KERNEL_WIDTH / 2;
+
+    for (int phase = 0; phase < PHASES; phase++) {
+        double sum = 0.0;
+        double taps[KERNEL_WIDTH];
+        for (int i = 0; i < KERNEL_WIDTH; i++) {
+            // Distance of tap i from the step, which sits between taps
+            // HALF - 1 and HALF at this phase
+            const double x = i - (HALF - 1) - static_cast<double>(phase) / PHASES;
+            const double arg = PI * CUTOFF * x;
+            const double sinc = (arg == 0.0) ? 1.0 : std::sin(arg) / arg;
+            const double window = 0.42 + 0.5 * std::cos(PI * x / HALF) + 0.08 * std::cos(2.0 * PI * x / HALF);
+            taps[i] = (std::fabs(x) < HALF) ? sinc * window : 0.0;
+            sum += taps[i];
+        }
+
+        // Each phase sums to 1 so a step settles at exactly its delta
+        for (int i = 0; i < KERNEL_WIDTH; i++) {
+            kernel[phase][i] = static_cast<float>(taps[i] / sum);
+        }
+    }
+}
+
+void BlipBuffer::setRates(double clockRate, double sampleRate, u32 maxFrameClocks)
+{
+    base_factor = static_cast<u64>(std::llround(sampleRate / clockRate * static_cast<double>(1ULL << FRAC_BITS)));
+    factor = base_factor;
+
+    // Sized for the fastest rate setRateScale allows
+    const double maxFactor = static_cast<double>(base_factor) * (1.0 + MAX_RATE_ADJUST);
+    max_samples = static_cast<size_t>((static_cast<u64>(maxFrameClocks) * static_cast<u64>(std::ceil(maxFactor))) >> FRAC_BITS) + 1;
+
+    // Room for a full frame on top of the unread one and the kernel tails
+    deltas.assign(max_samples * 2 + KERNEL_WIDTH, 0.0f);
+    clear();
+}
+
+void BlipBuffer::setRateScale(double scale)
+{
+    scale = std::clamp(scale, 1.0 - MAX_RATE_ADJUST, 1.0 + MAX_RATE_ADJUST);
+    factor = static_cast<u64>(std::llround(static_cast<double>(base_factor) * scale));
+}
+
+void BlipBuffer::clear()
+{
+    std::fill(deltas.begin(), deltas.end(), 0.0f);
+    offset = 0;
+    available = 0;
+    integrator = 0.0;
+}
+
+void BlipBuffer::addDelta(u32 time, float delta)
+{
+    const u64 pos = offset + time * factor;
+    const float* taps = kernel[(pos >> (FRAC_BITS - PHASE_BITS)) & (PHASES - 1)];
+    float* out = &deltas[pos >> FRAC_BITS];
+    for (int i = 0; i < KERNEL_WIDTH; i++) {
+        out[i] += taps[i] * delta;
+    }
+}
+
+void BlipBuffer::endFrame(u32 clocks)
+{
+    offset += clocks * factor;
+    available = offset >> FRAC_BITS;
+}
+
+size_t BlipBuffer::readSamples(float* out, size_t count)
+{
+    count = std::min(count, available);
+
+    double level = integrator;
+    for (size_t i = 0; i < count; i++) {
+        level += deltas[i];
+        out[i] = static_cast<float>(level);
+    }
+    integrator = level;
+
+    // Keep the partly accumulated samples after the read ones
+    const size_t pending = available - count + KERNEL_WIDTH;
+    std::copy(deltas.begin() + count, deltas.begin() + count + pending, deltas.begin());
+    std::fill(deltas.begin() + pending, deltas.begin() + count + pending, 0.0f);
+
+    offset -= static_cast<u64>(count) << FRAC_BITS;
+    available -= count;
+    return count;
+}
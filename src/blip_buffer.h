@@ -0,0 +1,65 @@
+#ifndef BLIP_BUFFER_H
+#define BLIP_BUFFER_H
+
+#include "types.h"
+#include <cstddef>
+#include <vector>
+
+// Band-limited step synthesis.
+//
+// Instead of sampling a waveform at the output rate, the source reports the
+// amplitude steps it makes (addDelta) at clock resolution. Each step is
+// spread over KERNEL_WIDTH output samples with a windowed-sinc kernel picked
+// by the step's sub-sample phase, and readSamples() integrates the deltas
+// back into a waveform in one pass. Steps cost work only when the output
+// changes and do not alias the way point sampling does.
+//
+// Output lags the input by KERNEL_WIDTH / 2 samples.
+class BlipBuffer {
+public:
+    BlipBuffer();
+
+    // Input clocks per second, output samples per second and the longest
+    // frame (in clocks) passed to endFrame(); drops buffered samples
+    void setRates(double clockRate, double sampleRate, u32 maxFrameClocks);
+    void clear();
+
+    // Most samples one frame of maxFrameClocks can produce, at any scale
+    size_t getMaxSamples() const { return max_samples; }
+
+    // Stretch the output rate by `scale`, clamped to 1 +- MAX_RATE_ADJUST,
+    // for dynamic rate control. Call between frames (after endFrame): times
+    // of the current frame must all use one rate.
+    static constexpr double MAX_RATE_ADJUST = 0.01;
+    void setRateScale(double scale);
+
+    // Add an amplitude step at `time` clocks into the current frame
+    void addDelta(u32 time, float delta);
+
+    // Close the current frame after `clocks` clocks; the next frame's times
+    // start from there and the finished samples become readable
+    void endFrame(u32 clocks);
+    size_t samplesAvailable() const { return available; }
+
+    // Integrate up to `count` finished samples into `out`; returns how many
+    size_t readSamples(float* out, size_t count);
+
+private:
+    static const int PHASE_BITS = 5;
+    static const int PHASES = 1 << PHASE_BITS;
+    static const int KERNEL_WIDTH = 16;
+    static const int FRAC_BITS = 32;   // of factor / offset
+
+    void buildKernel();
+
+    float kernel[PHASES][KERNEL_WIDTH];  // windowed-sinc impulse per phase
+    std::vector<float> deltas;           // [0] is the next unread sample
+    u64 base_factor;                     // samples per clock at scale 1
+    u64 factor;                          // samples per clock, fixed point
+    u64 offset;                          // frame start in samples, fixed point
+    size_t available;
+    size_t max_samples;
+    double integrator;                   // level at the last read sample
+};
+
+#endif // BLIP_BUFFER_H
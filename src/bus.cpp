@@ -4,29 +4,65 @@
 #include <charconv>
 #include <algorithm>
 #include "util.h"
+#include "profiler.h"
+#include "savestate.h"
 
 using vnes::util::toHex;
 using vnes::util::hexWord;
 Bus::Bus()
     : cpu(*this), ppu(*this, cartridge), apu(*this)
-    , system_cycles(0), log_accesses(false)
+    , system_cycles(0), apu_cycles(0), apu_deadline(0), paging_enabled(true)
+    , access_log(ACCESS_LOG_SIZE), access_head(0), access_count(0)
 {
     std::memset(ram, 0, sizeof(ram));
+    updatePageTable();
 }
 
 bool Bus::loadCartridge(const std::string& filepath)
 {
-    if (!cartridge.load(filepath)) return false;
+    const bool loaded = cartridge.load(filepath);
+    updatePageTable();
+    ppu.connectCartridge();
 
-    return true;
+    return loaded;
 }
 
-void Bus::updateInput()
+void Bus::updatePageTable()
 {
-    input.updateFromKeyboard();
+    for (int page = 0; page < PAGE_COUNT; page++) {
+        read_pages[page] = nullptr;
+        write_pages[page] = nullptr;
+    }
+    if (!paging_enabled) return;
+
+    // Internal RAM, mirrored every 2KB up to $1FFF
+    for (int page = 0; page < (0x2000 >> PAGE_SHIFT); page++) {
+        u8* mirror = ram + ((page << PAGE_SHIFT) & 0x07FF);
+        read_pages[page] = mirror;
+        write_pages[page] = mirror;
+    }
+
+    updateCartridgePages();
+    cartridge.takePrgMapChange();
 }
 
-std::string Bus::getRegionName(u16 addr) const
+void Bus::updateCartridgePages()
+{
+    if (!paging_enabled) return;
+
+    for (int page = 0x6000 >> PAGE_SHIFT; page < PAGE_COUNT; page++) {
+        const u16 addr = static_cast<u16>(page << PAGE_SHIFT);
+        read_pages[page] = cartridge.getPrgReadPage(addr, PAGE_SIZE);
+        write_pages[page] = cartridge.getPrgWritePage(addr);
+    }
+}
+
+void Bus::updateInput(u8 buttons)
+{
+    input.setState(buttons);
+}
+
+std::string Bus::getRegionName(u16 addr)
 {
     if (addr < 0x0800) {
         return std::string("RAM[$") + toHex(addr, 4) + "]";
@@ -81,16 +117,42 @@ std::string Bus::getRegionName(u16 addr) const
     }
 }
 
+void Bus::enableAccessLog(bool enable)
+{
+    paging_enabled = !enable;
+    updatePageTable();
+
+    if (enable) {
+        cpu.setBusHandlers(&Bus::readLogged, &Bus::writeLogged);
+    } else {
+        cpu.setBusHandlers(&Bus::read, &Bus::write);
+    }
+}
+
 void Bus::logAccess(MemAccess::Type type, u16 addr, u8 value)
 {
-    if (!log_accesses) return;
-    
-    MemAccess access;
-    access.type = type;
-    access.addr = addr;
-    access.value = value;
-    access.region = getRegionName(addr);
-    access_log.push_back(access);
+    access_log[access_head] = { addr, value, type };
+    access_head = (access_head + 1) % ACCESS_LOG_SIZE;
+    if (access_count < ACCESS_LOG_SIZE) access_count++;
+}
+
+const MemAccess& Bus::getAccess(size_t index) const
+{
+    const size_t first = (access_head + ACCESS_LOG_SIZE - access_count) % ACCESS_LOG_SIZE;
+    return access_log[(first + index) % ACCESS_LOG_SIZE];
+}
+
+u8 Bus::readLogged(u16 addr)
+{
+    const u8 data = read(addr);
+    logAccess(MemAccess::READ, addr, data);
+    return data;
+}
+
+void Bus::writeLogged(u16 addr, u8 data)
+{
+    logAccess(MemAccess::WRITE, addr, data);
+    write(addr, data);
 }
 
 void Bus::reset()
@@ -98,17 +160,39 @@ void Bus::reset()
     cpu.reset();
     ppu.reset();
     apu.reset();
-    system_cycles = 0;
+    system_cycles = cpu.getCycles();
+    apu_cycles = system_cycles;
+    updateApuDeadline();
 }
 
-void Bus::clock()
+void Bus::catchUp()
 {
+    const u64 target = cpu.getCycles();
+    if (system_cycles >= target) return;
+
+    const u32 elapsed = static_cast<u32>(target - system_cycles);
+    system_cycles = target;
+
     // PPU runs at 3x CPU speed
-    ppu.step();
+    ppu.run(elapsed * 3);
+}
+
+void Bus::catchUpApu()
+{
+    const u64 target = cpu.getCycles();
+    if (apu_cycles < target) {
+        apu.run(static_cast<u32>(target - apu_cycles));
+        apu_cycles = target;
+    }
+    updateApuDeadline();
+}
 
-    if (system_cycles % 3 == 0) {
-        cpu.step();
-        apu.step();
+void Bus::clock()
+{
+    cpu.step();
+    catchUp();
+    if (cpu.getCycles() >= apu_deadline) {
+        catchUpApu();
     }
 
     // Handle NMI from PPU
@@ -128,12 +212,147 @@ void Bus::clock()
         cartridge.clearIRQ();
         cpu.irq();
     }
+}
+
+void Bus::runFrame()
+{
+    VNES_PROFILE_SCOPE(ProfileStage::Emulation);
+
+    // Pick up Game Genie changes made between frames
+    if (cartridge.takePrgMapChange()) {
+        updateCartridgePages();
+    }
+
+    while (!ppu.isFrameComplete()) {
+        clock();
+    }
+    ppu.clearFrameComplete();
+    catchUpApu();
+    apu.flushSamples();
+}
+
+// Snapshot header: magic, format version, then cartridge identity so a
+// state cannot be loaded into a different game
+static const u8 STATE_MAGIC[4] = { 'V', 'N', 'S', 'S' };
+static const u32 STATE_VERSION = 2;
+
+struct StateHeader {
+    u8 magic[4];
+    u32 version;
+    u32 prg_size;
+    u32 chr_size;
+    u8 mapper;
+};
+
+static StateHeader makeStateHeader(const Cartridge& cart)
+{
+    StateHeader header{};
+    std::memcpy(header.magic, STATE_MAGIC, sizeof(header.magic));
+    header.version = STATE_VERSION;
+    header.prg_size = static_cast<u32>(cart.getPrgRom().size());
+    header.chr_size = static_cast<u32>(cart.getChrRom().size());
+    header.mapper = cart.getMapperNumber();
+    return header;
+}
+
+void Bus::saveState(std::vector<u8>& out)
+{
+    out.clear();
+    catchUpApu();
+
+    StateStream s(out);
+    StateHeader header = makeStateHeader(cartridge);
+    s.io(header);
 
-    system_cycles++;
+    s.io(ram);
+    s.io(system_cycles);
+    cpu.serialize(s);
+    ppu.serialize(s);
+    apu.serialize(s);
+    input.serialize(s);
+    cartridge.serialize(s);
+}
+
+bool Bus::loadState(std::span<const u8> data)
+{
+    StateStream s(data);
+
+    StateHeader header{};
+    s.io(header);
+    const StateHeader expected = makeStateHeader(cartridge);
+    if (!s.ok()
+        || std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0
+        || header.version != expected.version
+        || header.prg_size != expected.prg_size
+        || header.chr_size != expected.chr_size
+        || header.mapper != expected.mapper) {
+        return false;
+    }
+
+    // Keep the current state so a truncated snapshot cannot leave the
+    // machine half-loaded
+    std::vector<u8> backup;
+    saveState(backup);
+
+    if (!readState(s)) {
+        loadState(backup);
+        return false;
+    }
+    return true;
+}
+
+void Bus::restoreState(std::span<const u8> data)
+{
+    StateStream s(data);
+    StateHeader header{};
+    s.io(header);
+    readState(s);
+}
+
+bool Bus::readState(StateStream& s)
+{
+    s.io(ram);
+    s.io(system_cycles);
+    cpu.serialize(s);
+    ppu.serialize(s);
+    apu.serialize(s);
+    input.serialize(s);
+    cartridge.serialize(s);
+    updatePageTable();
+    ppu.updateNametableMap();
+    // States are taken with the APU caught up
+    apu_cycles = system_cycles;
+    updateApuDeadline();
+
+    return s.ok() && s.atEnd();
+}
+
+void Bus::runAhead(int frames)
+{
+    if (frames <= 0) {
+        return;
+    }
+
+    saveState(run_ahead_state);
+    AudioSink* sink = apu.getAudioSink();
+    apu.setAudioSink(nullptr);
+    cartridge.setSpeculative(true);
+
+    for (int i = 0; i < frames; i++) {
+        runFrame();
+    }
+
+    cartridge.setSpeculative(false);
+    restoreState(run_ahead_state);
+    apu.setAudioSink(sink);
 }
 
 u8 Bus::read(u16 addr)
 {
+    if (const u8* page = read_pages[addr >> PAGE_SHIFT]) {
+        return page[addr & (PAGE_SIZE - 1)];
+    }
+
     u8 data = 0;
     
     if (addr < 0x2000) {
@@ -142,6 +361,7 @@ u8 Bus::read(u16 addr)
     }
     else if (addr < 0x4000) {
         // PPU registers (mirrored every 8 bytes)
+        catchUp();
         data = ppu.readRegister(addr);
     }
     else if (addr < 0x4018) {
@@ -155,6 +375,7 @@ u8 Bus::read(u16 addr)
             data = 0x40;
         }
         else {
+            catchUpApu();
             data = apu.readRegister(addr);
         }
     }
@@ -163,27 +384,73 @@ u8 Bus::read(u16 addr)
         data = cartridge.readPrg(addr);
     }
 
-    logAccess(MemAccess::READ, addr, data);
     return data;
 }
 
+u8 Bus::peek(u16 addr) const
+{
+    if (const u8* page = read_pages[addr >> PAGE_SHIFT]) {
+        return page[addr & (PAGE_SIZE - 1)];
+    }
+
+    if (addr < 0x2000) {
+        return ram[addr & 0x07FF];
+    }
+    else if (addr < 0x4000) {
+        return ppu.peekRegister(addr);
+    }
+    else if (addr < 0x4018) {
+        if (addr == 0x4016) return input.peek();
+        if (addr == 0x4017) return 0x40;
+        return apu.peekRegister(addr);
+    }
+    else if (addr >= 0x4020 && cartridge.isLoaded()) {
+        return cartridge.readPrg(addr);
+    }
+
+    return 0;
+}
+
+void Bus::peekPage(u8 page, u8* out) const
+{
+    const u16 base = static_cast<u16>(page << 8);
+
+    if (const u8* direct = read_pages[base >> PAGE_SHIFT]) {
+        std::memcpy(out, direct + (base & (PAGE_SIZE - 1)), 256);
+    }
+    else if (base < 0x2000) {
+        std::memcpy(out, ram + (base & 0x07FF), 256);
+    }
+    else {
+        for (int i = 0; i < 256; i++) {
+            out[i] = peek(static_cast<u16>(base + i));
+        }
+    }
+}
+
 void Bus::write(u16 addr, u8 data)
 {
-    logAccess(MemAccess::WRITE, addr, data);
-    
+    if (u8* page = write_pages[addr >> PAGE_SHIFT]) {
+        page[addr & (PAGE_SIZE - 1)] = data;
+        return;
+    }
+
     if (addr < 0x2000) {
         // Internal RAM
         ram[addr & 0x07FF] = data;
     }
     else if (addr < 0x4000) {
         // PPU registers
+        catchUp();
         ppu.writeRegister(addr, data);
     }
     else if (addr < 0x4018) {
         // APU and I/O registers
         if (addr == 0x4014) {
-            // OAM DMA
+            // OAM DMA - halts the CPU for 513 cycles (+1 on an odd cycle)
+            catchUp();
             ppu.writeDMA(data);
+            cpu.addCycles(513 + (cpu.getCycles() & 1));
         }
         else if (addr == 0x4016) {
             // Controller strobe
@@ -192,11 +459,25 @@ void Bus::write(u16 addr, u8 data)
             }
         }
         else {
+            catchUpApu();
             apu.writeRegister(addr, data);
+            updateApuDeadline();
         }
     }
     else if (addr >= 0x4020) {
         // Cartridge space ($6000-$FFFF: PRG RAM and mapper registers)
+        // Mapper state (banks, mirroring, IRQ counters) is observed by the PPU,
+        // and PRG banks by DMC sample fetches
+        catchUp();
+        catchUpApu();
         cartridge.writePrg(addr, data);
+
+        // Bank switches and RAM enable changes republish the PRG pages
+        if (cartridge.takePrgMapChange()) {
+            updateCartridgePages();
+        }
+        if (cartridge.takeMirroringChange()) {
+            ppu.updateNametableMap();
+        }
     }
 }
@@ -8,15 +8,16 @@
 #include "cartridge.h"
 #include "input.h"
 #include <vector>
+#include <span>
 #include <string>
 
-// Memory access record for debugging
+// Memory access record for debugging (fixed-size so the log never allocates;
+// use Bus::getRegionName to describe addr when displaying it)
 struct MemAccess {
-    enum Type { READ, WRITE };
-    Type type;
+    enum Type : u8 { READ, WRITE };
     u16 addr;
     u8 value;
-    std::string region;  // Description of memory region
+    Type type;
 };
 
 class Bus {
@@ -26,16 +27,54 @@ public:
     bool loadCartridge(const std::string& filepath);
     void reset();
 
-    // Clock the entire system
+    // Execute one CPU instruction, then catch the PPU and APU up by the
+    // cycles it consumed and service pending interrupts
     void clock();
 
+    // Run until the PPU completes the current frame
+    void runFrame();
+
+    // Run-ahead: emulate `frames` more frames with the current input, which
+    // leaves the last one in the PPU's framebuffer, then roll back to the
+    // current state. No audio is produced and no battery save is written
+    // for the speculative frames.
+    void runAhead(int frames);
+
     // Update input state (call once per frame before clocking)
-    void updateInput();
+    void updateInput(u8 buttons);
+
+    // Save states: a versioned binary snapshot of CPU, PPU, APU, RAM,
+    // controller shift state and cartridge RAM/mapper registers. loadState
+    // rejects snapshots from another format version or cartridge and leaves
+    // the machine untouched in that case.
+    void saveState(std::vector<u8>& out);
+    bool loadState(std::span<const u8> data);
+
+    // Load a snapshot this Bus saved itself, skipping the validation and
+    // backup of loadState (run-ahead restores one every frame)
+    void restoreState(std::span<const u8> data);
 
     // CPU memory interface
     u8 read(u16 addr);
     void write(u16 addr, u8 data);
 
+    // Debugger view of CPU memory: the value read() would return, without
+    // its side effects (PPUSTATUS/PPUDATA, $4015 and controller reads change
+    // nothing), without catching the PPU/APU up and without access logging.
+    // peekPage copies the 256 bytes at page << 8 into `out`, straight from
+    // the page table where it can.
+    u8 peek(u16 addr) const;
+    void peekPage(u8 page, u8* out) const;
+
+    // CPU page table: 1KB pages with a direct pointer for plain memory (RAM,
+    // PRG RAM, mapped PRG ROM). A null page has side effects (registers,
+    // mapper writes, Game Genie) and goes through read()/write().
+    static const int PAGE_SHIFT = 10;
+    static const u16 PAGE_SIZE = 1 << PAGE_SHIFT;
+    static const int PAGE_COUNT = 0x10000 >> PAGE_SHIFT;
+    const u8* getReadPage(u16 addr) const { return read_pages[addr >> PAGE_SHIFT]; }
+    u8* getWritePage(u16 addr) const { return write_pages[addr >> PAGE_SHIFT]; }
+
     // Components (public for direct access)
     CPU cpu;
     PPU ppu;
@@ -43,24 +82,60 @@ public:
     Cartridge cartridge;
     Input input;
 
-    // Debug: memory access tracking
-    void enableAccessLog(bool enable) { log_accesses = enable; }
-    void clearAccessLog() { access_log.clear(); }
-    const std::vector<MemAccess>& getAccessLog() const { return access_log; }
+    // Debug: memory access tracking. Enabling the log switches the CPU to
+    // the logging read/write handlers; the normal path never checks for it.
+    // The log is a ring of the last ACCESS_LOG_SIZE accesses.
+    static const size_t ACCESS_LOG_SIZE = 4096;
+    void enableAccessLog(bool enable);
+    void clearAccessLog() { access_head = 0; access_count = 0; }
+    size_t getAccessCount() const { return access_count; }
+    const MemAccess& getAccess(size_t index) const;    // 0 = oldest
+    static std::string getRegionName(u16 addr);
+
+    // CPU memory interface with access logging (selected by enableAccessLog)
+    u8 readLogged(u16 addr);
+    void writeLogged(u16 addr, u8 data);
 
 private:
     // Internal RAM (2KB, mirrored)
     u8 ram[2048];
 
-    // System cycles
+    // CPU cycle count the PPU has been advanced to
     u64 system_cycles;
 
-    // Debug: access logging
-    bool log_accesses;
+    // Run the PPU forward until it matches the CPU's cycle count.
+    // Called after every instruction and before any access with timing
+    // side effects (PPU registers, OAM DMA, mapper writes).
+    void catchUp();
+
+    // Body shared by loadState/restoreState, after the header
+    bool readState(StateStream& s);
+    std::vector<u8> run_ahead_state;
+
+    // The APU is only advanced when something can observe it: its
+    // registers, mapper writes (DMC fetches read PRG), the end of a frame,
+    // a save state, or the earliest cycle its frame/DMC IRQ could assert
+    // (apu_deadline). Most instructions never touch it.
+    u64 apu_cycles;
+    u64 apu_deadline;
+    void catchUpApu();
+    void updateApuDeadline() { apu_deadline = apu_cycles + apu.cyclesUntilIrq(); }
+
+    // CPU page table (see getReadPage); left empty while the access log is
+    // active so that every access reaches the logging handlers
+    const u8* read_pages[PAGE_COUNT];
+    u8* write_pages[PAGE_COUNT];
+    bool paging_enabled;
+
+    void updatePageTable();
+    void updateCartridgePages();
+
+    // Debug: access log ring
     std::vector<MemAccess> access_log;
-    
+    size_t access_head;
+    size_t access_count;
+
     void logAccess(MemAccess::Type type, u16 addr, u8 value);
-    std::string getRegionName(u16 addr) const;
 };
 
 #endif // BUS_H
@@ -5,6 +5,7 @@
 #include <charconv>
 #include <algorithm>
 #include "util.h"
+#include "savestate.h"
 
 using vnes::util::toHex;
 using vnes::util::hexByte;
@@ -14,11 +15,15 @@ Cartridge::Cartridge()
     : loaded(false)
     , mapperNumber(0)
     , battery(false)
+    , chr_ram(false)
+    , chr_generation(0)
+    , gg_count(0)
+    , gg_changed(false)
     , mapper(nullptr)
     , initialMirroring(Mirroring::HORIZONTAL)
     , prgRamDirty(false)
     , framesSinceLastSave(0)
-    , gg_count(0)
+    , speculative(false)
 {
     gg_count = 0;
     for (size_t i = 0; i < gg_active_entries.size(); ++i) gg_active_entries[i] = GGActiveEntry();
@@ -87,6 +92,7 @@ bool Cartridge::addGGCode(const std::string& code)
     for (size_t k = 0; k < gg_count; ++k) {
         if (gg_active_entries[k].addr == addr) {
             gg_active_entries[k] = entry;
+            gg_changed = true;
             return true;
         }
     }
@@ -95,6 +101,7 @@ bool Cartridge::addGGCode(const std::string& code)
     if (gg_count < MAX_GG_CODES) {
         gg_active_entries[gg_count] = entry;
         ++gg_count;
+        gg_changed = true;
         return true;
     }
 
@@ -111,6 +118,7 @@ void Cartridge::removeGGCode(const std::string& code)
             if (k != last) gg_active_entries[k] = gg_active_entries[last];
             gg_active_entries[last] = GGActiveEntry();
             --gg_count;
+            gg_changed = true;
             return;
         }
     }
@@ -127,6 +135,9 @@ bool Cartridge::load(const std::string& filepath)
 	prg_rom.clear();
 	chr_rom.clear();
 	prg_ram.clear();
+	nt_vram.clear();
+	// Keep getChrGeneration() moving forward past the old mapper's count
+	chr_generation = getChrGeneration() + 1;
 	mapper.reset();
 
     // clear active entries
@@ -172,6 +183,7 @@ bool Cartridge::load(const std::string& filepath)
 
 	// Read CHR ROM (or allocate CHR RAM if size is 0)
 	u32 chr_size = header.chr_rom_size * CHR_ROM_UNIT;
+	chr_ram = (chr_size == 0);
 	if (chr_size > 0) {
 		chr_rom.resize(chr_size);
 		file.read(reinterpret_cast<char*>(chr_rom.data()), chr_size);
@@ -188,6 +200,11 @@ bool Cartridge::load(const std::string& filepath)
 	// Allocate 8KB PRG RAM at $6000-$7FFF
 	prg_ram.resize(8192, 0);
 
+	// Four-screen boards carry their own RAM for the second pair of nametables
+	if (initialMirroring == Mirroring::FOUR_SCREEN) {
+		nt_vram.resize(2048, 0);
+	}
+
 	// Create and initialize the mapper
 	mapper = MapperFactory::create(mapperNumber);
 	mapper->init(prg_rom, chr_rom, prg_ram, initialMirroring);
@@ -305,7 +322,7 @@ u8 Cartridge::readPrg(u16 addr) const
 void Cartridge::writePrg(u16 addr, u8 data)
 {
 	// Check if writing to PRG RAM for battery-backed save detection
-	if (battery && addr >= 0x6000 && addr < 0x8000) {
+	if (battery && !speculative && addr >= 0x6000 && addr < 0x8000) {
 		prgRamDirty = true;
 		framesSinceLastSave = 0;
 	}
@@ -313,6 +330,40 @@ void Cartridge::writePrg(u16 addr, u8 data)
 	mapper->writePrg(addr, data);
 }
 
+const u8* Cartridge::getPrgReadPage(u16 addr, u16 size) const
+{
+	if (!mapper || addr < 0x6000) return nullptr;
+
+	const u8* slot = mapper->getPrgReadSlot((addr - 0x6000) / PRG_BANK_8K);
+	if (!slot) return nullptr;
+
+	for (size_t k = 0; k < gg_count; ++k) {
+		const u16 patched = gg_active_entries[k].addr;
+		if (patched >= addr && patched - addr < size) return nullptr;
+	}
+
+	return slot + (addr & (PRG_BANK_8K - 1));
+}
+
+u8* Cartridge::getPrgWritePage(u16 addr) const
+{
+	if (!mapper || addr < 0x6000) return nullptr;
+
+	// Battery RAM writes must reach writePrg to mark the save dirty
+	if (battery && addr < 0x8000) return nullptr;
+
+	u8* slot = mapper->getPrgWriteSlot((addr - 0x6000) / PRG_BANK_8K);
+	return slot ? slot + (addr & (PRG_BANK_8K - 1)) : nullptr;
+}
+
+bool Cartridge::takePrgMapChange()
+{
+	const bool mapper_changed = mapper && mapper->takePrgMapChange();
+	const bool changed = mapper_changed || gg_changed;
+	gg_changed = false;
+	return changed;
+}
+
 u8 Cartridge::readChr(u16 addr) const
 {
 	return mapper->readChr(addr);
@@ -320,9 +371,27 @@ u8 Cartridge::readChr(u16 addr) const
 
 void Cartridge::writeChr(u16 addr, u8 data)
 {
+	chr_generation++;
 	mapper->writeChr(addr, data);
 }
 
+void Cartridge::serialize(StateStream& s)
+{
+	s.io(prg_ram);
+	if (chr_ram) {
+		s.io(chr_rom);
+		if (s.isLoading()) {
+			chr_generation++;
+		}
+	}
+	if (!nt_vram.empty()) {
+		s.io(nt_vram);
+	}
+	if (mapper) {
+		mapper->serialize(s);
+	}
+}
+
 void Cartridge::signalFrameComplete()
 {
 	if (!battery || !prgRamDirty) {
@@ -360,7 +429,7 @@ bool Cartridge::hasIRQ()
 
 void Cartridge::flushSRAM()
 {
-	if (!battery || !prgRamDirty || prg_ram.empty() || savePath.empty()) {
+	if (!battery || !prgRamDirty || speculative || prg_ram.empty() || savePath.empty()) {
 		return;
 	}
 
@@ -9,6 +9,8 @@
 #include "mapper.h"
 #include "types.h"
 
+class StateStream;
+
 // iNES Header (16 bytes)
 struct INESHeader {
     u8 magic[4];      // "NES" + 0x1A
@@ -46,10 +48,29 @@ public:
     u8 readPrg(u16 addr) const;
     void writePrg(u16 addr, u8 data);
     
+    // Direct pointer to `size` bytes of CPU space at `addr` ($6000-$FFFF,
+    // within one 8KB slot) for the bus page table, or nullptr when accesses
+    // must go through readPrg/writePrg (registers, Game Genie patches,
+    // battery RAM dirty tracking)
+    const u8* getPrgReadPage(u16 addr, u16 size) const;
+    u8* getPrgWritePage(u16 addr) const;
+
+    // True (once) after the pages above may have changed
+    bool takePrgMapChange();
+
+    // Nametable layout: true (once) after the mapper switched mirroring, and
+    // the extra 2KB of nametable RAM on four-screen boards (else nullptr)
+    bool takeMirroringChange() { return mapper && mapper->takeMirroringChange(); }
+    u8* getFourScreenVram() { return nt_vram.empty() ? nullptr : nt_vram.data(); }
+
     // PPU interface for CHR space ($0000-$1FFF)
     u8 readChr(u16 addr) const;
     void writeChr(u16 addr, u8 data);
 
+    // Changes whenever the pattern tables may have: CHR writes, bank
+    // switches, state loads and ROM loads (debug viewers cache on it)
+    u32 getChrGeneration() const { return chr_generation + (mapper ? mapper->getChrGeneration() : 0); }
+
 	// Mapper-specific timing (for mappers that need it, eg: MMC3)
     void scanline();
     void clearIRQ();
@@ -61,16 +82,26 @@ public:
     void signalFrameComplete();
     void flushSRAM();
 
+    // Set while running frames that will be rolled back (run-ahead):
+    // battery RAM writes do not mark the save dirty and nothing is flushed
+    void setSpeculative(bool enable) { speculative = enable; }
+
+    // Save-state support: PRG-RAM, CHR-RAM (if any) and mapper registers
+    void serialize(StateStream& s);
+
 private:
     bool parseHeader(const INESHeader& header);
     
     bool loaded;
     u8 mapperNumber;
     bool battery;
+    bool chr_ram;             // chr_rom holds writable CHR RAM
+    u32 chr_generation;       // CHR writes and loads (see getChrGeneration)
 
     std::vector<u8> prg_rom;  // Program ROM
     std::vector<u8> chr_rom;  // Character ROM (can be RAM if size=0)
     std::vector<u8> prg_ram;  // PRG RAM at $6000-$7FFF (8KB)
+    std::vector<u8> nt_vram;  // Nametables 2 and 3 on four-screen boards
 
     // Active Game Genie entries. We keep a small dense array of at most
     // MAX_GG_CODES entries and a `gg_count` to avoid scanning when empty.
@@ -85,6 +116,7 @@ private:
         u32 hits = 0;
     };
     std::array<GGActiveEntry, MAX_GG_CODES> gg_active_entries;
+    bool gg_changed;          // Patched pages must leave the page table
     
     // The pluggable mapper
     std::unique_ptr<Mapper> mapper;
@@ -95,6 +127,7 @@ private:
     // SRAM persistence (for battery-backed carts)
     bool prgRamDirty;
     u32 framesSinceLastSave;
+    bool speculative;
     std::string savePath;
 };
 
@@ -1,5 +1,6 @@
 #include "cpu.h"
 #include "bus.h"
+#include "savestate.h"
 #include <bit>  // std::bit_cast
 
 // ---------------------------------------------------------------------------
@@ -14,7 +15,7 @@ static constexpr u8 asBit(Flag f) noexcept
 // Construction
 // ---------------------------------------------------------------------------
 CPU::CPU(Bus& b)
-    : bus(b), pc{ 0 }, sp{ 0 }, a{ 0 }, x{ 0 }, y{ 0 }, status{ 0 }, cycles{ 0 }
+    : bus(b), read_handler(&Bus::read), write_handler(&Bus::write), pc{ 0 }, sp{ 0 }, a{ 0 }, x{ 0 }, y{ 0 }, status{ 0 }, cycles{ 0 }
 {
 }
 
@@ -54,17 +55,40 @@ void CPU::nmi()
     cycles += 7;
 }
 
+// ---------------------------------------------------------------------------
+// Save state
+// ---------------------------------------------------------------------------
+void CPU::serialize(StateStream& s)
+{
+    s.io(pc);
+    s.io(sp);
+    s.io(a);
+    s.io(x);
+    s.io(y);
+    s.io(status);
+    s.io(cycles);
+}
+
 // ---------------------------------------------------------------------------
 // Memory
 // ---------------------------------------------------------------------------
+// Plain memory is read straight from the bus page table; everything else
+// (registers, mapper writes, logging) goes through the bus handlers
 u8 CPU::read(u16 addr)
 {
-    return bus.read(addr);
+    if (const u8* page = bus.getReadPage(addr)) {
+        return page[addr & (Bus::PAGE_SIZE - 1)];
+    }
+    return (bus.*read_handler)(addr);
 }
 
 void CPU::write(u16 addr, u8 data)
 {
-    bus.write(addr, data);
+    if (u8* page = bus.getWritePage(addr)) {
+        page[addr & (Bus::PAGE_SIZE - 1)] = data;
+        return;
+    }
+    (bus.*write_handler)(addr, data);
 }
 
 // Little-endian 16-bit read — used only for fixed interrupt vectors
@@ -137,13 +161,11 @@ u16 CPU::addr_zp() { return read(pc++); }   // zero page is always 0x00xx
 
 u16 CPU::addr_zpx()
 {
-    ++cycles;
     return static_cast<u8>(read(pc++) + x);  // wraps within zero page
 }
 
 u16 CPU::addr_zpy()
 {
-    ++cycles;
     return static_cast<u8>(read(pc++) + y);
 }
 
@@ -154,23 +176,23 @@ u16 CPU::addr_abs()
     return static_cast<u16>((hi << 8) | lo);
 }
 
-u16 CPU::addr_abx()
+u16 CPU::addr_abx(bool page_penalty)
 {
     const u16 lo = read(pc++);
     const u16 hi = read(pc++);
     const u16 base = static_cast<u16>((hi << 8) | lo);
     const u16 addr = static_cast<u16>(base + x);
-    if ((addr & 0xFF00) != (base & 0xFF00)) ++cycles;  // page cross
+    if (page_penalty && (addr & 0xFF00) != (base & 0xFF00)) ++cycles;  // page cross
     return addr;
 }
 
-u16 CPU::addr_aby()
+u16 CPU::addr_aby(bool page_penalty)
 {
     const u16 lo = read(pc++);
     const u16 hi = read(pc++);
     const u16 base = static_cast<u16>((hi << 8) | lo);
     const u16 addr = static_cast<u16>(base + y);
-    if ((addr & 0xFF00) != (base & 0xFF00)) ++cycles;
+    if (page_penalty && (addr & 0xFF00) != (base & 0xFF00)) ++cycles;
     return addr;
 }
 
@@ -188,20 +210,19 @@ u16 CPU::addr_ind()
 u16 CPU::addr_izx()
 {
     const u8 ptr = static_cast<u8>(read(pc++) + x);
-    ++cycles;
     const u16 lo = read(static_cast<u8>(ptr));
     const u16 hi = read(static_cast<u8>(ptr + 1u));
     return static_cast<u16>((hi << 8) | lo);
 }
 
-u16 CPU::addr_izy()
+u16 CPU::addr_izy(bool page_penalty)
 {
     const u8  ptr = read(pc++);
     const u16 lo = read(ptr);
     const u16 hi = read(static_cast<u8>(ptr + 1u));
     const u16 base = static_cast<u16>((hi << 8) | lo);
     const u16 addr = static_cast<u16>(base + y);
-    if ((addr & 0xFF00) != (base & 0xFF00)) ++cycles;
+    if (page_penalty && (addr & 0xFF00) != (base & 0xFF00)) ++cycles;
     return addr;
 }
 
@@ -249,7 +270,6 @@ void CPU::op_asl(u16 addr)
     m <<= 1;
     write(addr, m);
     updateZN(m);
-    ++cycles;
 }
 
 void CPU::op_bcc() { branch(!getFlag(Flag::C)); }
@@ -294,7 +314,6 @@ void CPU::op_dec(u16 addr)
     const u8 m = static_cast<u8>(read(addr) - 1u);
     write(addr, m);
     updateZN(m);
-    ++cycles;
 }
 
 void CPU::op_dex() { --x; updateZN(x); }
@@ -305,7 +324,6 @@ void CPU::op_inc(u16 addr)
     const u8 m = static_cast<u8>(read(addr) + 1u);
     write(addr, m);
     updateZN(m);
-    ++cycles;
 }
 
 void CPU::op_inx() { ++x; updateZN(x); }
@@ -334,20 +352,18 @@ void CPU::op_lsr(u16 addr)
     m >>= 1;
     write(addr, m);
     updateZN(m);
-    ++cycles;
 }
 
 void CPU::op_nop() {}
 void CPU::op_ora(u16 addr) { a |= read(addr); updateZN(a); }
 void CPU::op_pha() { push<u8>(a); }
 void CPU::op_php() { push<u8>(status | asBit(Flag::B) | asBit(Flag::U)); }
-void CPU::op_pla() { a = pull<u8>(); updateZN(a); ++cycles; }
+void CPU::op_pla() { a = pull<u8>(); updateZN(a); }
 void CPU::op_plp()
 {
     status = pull<u8>();
     setFlag(Flag::U, true);
     setFlag(Flag::B, false);
-    ++cycles;
 }
 
 void CPU::op_rol_a()
@@ -366,7 +382,6 @@ void CPU::op_rol(u16 addr)
     m = static_cast<u8>((m << 1) | carry);
     write(addr, m);
     updateZN(m);
-    ++cycles;
 }
 
 void CPU::op_ror_a()
@@ -385,7 +400,6 @@ void CPU::op_ror(u16 addr)
     m = static_cast<u8>((m >> 1) | carry);
     write(addr, m);
     updateZN(m);
-    ++cycles;
 }
 
 void CPU::op_rti()
@@ -461,7 +475,7 @@ void CPU::step()
     case 0x06: cycles += 5; op_asl(addr_zp());   break;
     case 0x16: cycles += 6; op_asl(addr_zpx());  break;
     case 0x0E: cycles += 6; op_asl(addr_abs());  break;
-    case 0x1E: cycles += 7; op_asl(addr_abx());  break;
+    case 0x1E: cycles += 7; op_asl(addr_abx(false));  break;
 
     // ── Branches ───────────────────────────────────────────────────────
     case 0x90: cycles += 2; op_bcc(); break;
@@ -510,7 +524,7 @@ void CPU::step()
     case 0xC6: cycles += 5; op_dec(addr_zp());  break;
     case 0xD6: cycles += 6; op_dec(addr_zpx()); break;
     case 0xCE: cycles += 6; op_dec(addr_abs()); break;
-    case 0xDE: cycles += 7; op_dec(addr_abx()); break;
+    case 0xDE: cycles += 7; op_dec(addr_abx(false)); break;
 
     // ── DEX / DEY ──────────────────────────────────────────────────────
     case 0xCA: cycles += 2; op_dex(); break;
@@ -530,7 +544,7 @@ void CPU::step()
     case 0xE6: cycles += 5; op_inc(addr_zp());  break;
     case 0xF6: cycles += 6; op_inc(addr_zpx()); break;
     case 0xEE: cycles += 6; op_inc(addr_abs()); break;
-    case 0xFE: cycles += 7; op_inc(addr_abx()); break;
+    case 0xFE: cycles += 7; op_inc(addr_abx(false)); break;
 
     // ── INX / INY ──────────────────────────────────────────────────────
     case 0xE8: cycles += 2; op_inx(); break;
@@ -570,7 +584,7 @@ void CPU::step()
     case 0x46: cycles += 5; op_lsr(addr_zp());   break;
     case 0x56: cycles += 6; op_lsr(addr_zpx());  break;
     case 0x4E: cycles += 6; op_lsr(addr_abs());  break;
-    case 0x5E: cycles += 7; op_lsr(addr_abx());  break;
+    case 0x5E: cycles += 7; op_lsr(addr_abx(false));  break;
 
     // ── NOP (official + common unofficial) ─────────────────────────────
     case 0xEA:
@@ -599,14 +613,14 @@ void CPU::step()
     case 0x26: cycles += 5; op_rol(addr_zp());   break;
     case 0x36: cycles += 6; op_rol(addr_zpx());  break;
     case 0x2E: cycles += 6; op_rol(addr_abs());  break;
-    case 0x3E: cycles += 7; op_rol(addr_abx());  break;
+    case 0x3E: cycles += 7; op_rol(addr_abx(false));  break;
 
     // ── ROR ────────────────────────────────────────────────────────────
     case 0x6A: cycles += 2; op_ror_a();          break;
     case 0x66: cycles += 5; op_ror(addr_zp());   break;
     case 0x76: cycles += 6; op_ror(addr_zpx());  break;
     case 0x6E: cycles += 6; op_ror(addr_abs());  break;
-    case 0x7E: cycles += 7; op_ror(addr_abx());  break;
+    case 0x7E: cycles += 7; op_ror(addr_abx(false));  break;
 
     // ── RTI / RTS ──────────────────────────────────────────────────────
     case 0x40: cycles += 6; op_rti(); break;
@@ -631,10 +645,10 @@ void CPU::step()
     case 0x85: cycles += 3; op_sta(addr_zp());  break;
     case 0x95: cycles += 4; op_sta(addr_zpx()); break;
     case 0x8D: cycles += 4; op_sta(addr_abs()); break;
-    case 0x9D: cycles += 5; op_sta(addr_abx()); break;
-    case 0x99: cycles += 5; op_sta(addr_aby()); break;
+    case 0x9D: cycles += 5; op_sta(addr_abx(false)); break;
+    case 0x99: cycles += 5; op_sta(addr_aby(false)); break;
     case 0x81: cycles += 6; op_sta(addr_izx()); break;
-    case 0x91: cycles += 6; op_sta(addr_izy()); break;
+    case 0x91: cycles += 6; op_sta(addr_izy(false)); break;
 
     // ── STX ────────────────────────────────────────────────────────────
     case 0x86: cycles += 3; op_stx(addr_zp());  break;
@@ -7,6 +7,7 @@
 
 // Forward declaration to avoid circular dependency with Bus
 class Bus;
+class StateStream;
 
 // Strongly-typed flag enum � no accidental int conversions
 enum class Flag : u8 {
@@ -40,6 +41,9 @@ public:
     [[nodiscard]] u8  getStatus() const noexcept { return status; }
     [[nodiscard]] u64 getCycles() const noexcept { return cycles; }
 
+    // Stall the CPU (e.g. OAM DMA); the bus catches the PPU/APU up afterwards
+    void addCycles(u32 n) noexcept { cycles += n; }
+
     [[nodiscard]] bool getFlag(Flag f) const noexcept;
 
     void setPC(u16 v)    noexcept { pc = v; }
@@ -49,6 +53,15 @@ public:
     void setY(u8 v)      noexcept { y = v; }
     void setStatus(u8 v) noexcept { status = v; }
 
+    // Save-state support (registers and cycle counter)
+    void serialize(StateStream& s);
+
+    // Bus entry points used for every memory access. The bus swaps in its
+    // logging variants while the debugger traces an instruction.
+    using ReadHandler = u8 (Bus::*)(u16);
+    using WriteHandler = void (Bus::*)(u16, u8);
+    void setBusHandlers(ReadHandler r, WriteHandler w) noexcept { read_handler = r; write_handler = w; }
+
 private:
     [[nodiscard]] u8  read(u16 addr);
     void              write(u16 addr, u8 data);
@@ -69,14 +82,18 @@ private:
     [[nodiscard]] u16 addr_zpx();
     [[nodiscard]] u16 addr_zpy();
     [[nodiscard]] u16 addr_abs();
-    [[nodiscard]] u16 addr_abx();
-    [[nodiscard]] u16 addr_aby();
+    // Indexed modes add a cycle on page cross; stores and read-modify-write
+    // instructions always take the fixed count, so they pass false
+    [[nodiscard]] u16 addr_abx(bool page_penalty = true);
+    [[nodiscard]] u16 addr_aby(bool page_penalty = true);
     [[nodiscard]] u16 addr_ind();
     [[nodiscard]] u16 addr_izx();
-    [[nodiscard]] u16 addr_izy();
+    [[nodiscard]] u16 addr_izy(bool page_penalty = true);
 
     // Bus reference
     Bus& bus;
+    ReadHandler read_handler;
+    WriteHandler write_handler;
 
     // Instructions
     void op_adc(u16 addr);
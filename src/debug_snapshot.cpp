@@ -0,0 +1,92 @@
+#include "debug_snapshot.h"
+#include "bus.h"
+#include <cstring>
+
+void DebugSnapshot::capture(const Bus& bus, MemoryView view)
+{
+    pc = bus.cpu.getPC();
+    sp = bus.cpu.getSP();
+    a = bus.cpu.getA();
+    x = bus.cpu.getX();
+    y = bus.cpu.getY();
+    status = bus.cpu.getStatus();
+    cycles = bus.cpu.getCycles();
+    for (int i = 0; i < CODE_BYTES; i++) {
+        code[i] = bus.peek(static_cast<u16>(pc + i));
+    }
+    bus.peekPage(0x01, stack.data());
+
+    // Two pages, wrapping at the end of the address space
+    memory_view = view;
+    const u8 lastPage = view.ppu ? 0x3F : 0xFF;
+    for (int i = 0; i < 2; i++) {
+        const u8 page = static_cast<u8>((view.page + i) & lastPage);
+        if (view.ppu) {
+            bus.ppu.peekVramPage(page, memory.data() + i * 256);
+        } else {
+            bus.peekPage(page, memory.data() + i * 256);
+        }
+    }
+
+    const PPU& ppu = bus.ppu;
+    scanline = ppu.getScanline();
+    ppu_cycle = ppu.getCycle();
+    vram_addr = ppu.getVramAddr();
+    temp_addr = ppu.getTempAddr();
+    fine_x = ppu.getFineX();
+    write_toggle = ppu.getWriteToggle();
+    frame_complete = ppu.isFrameComplete();
+    nmi = ppu.isNMI();
+    ctrl = ppu.getCtrl();
+    mask = ppu.getMask();
+    ppu_status = ppu.getStatus();
+    // As read through $3F00-$3F1F: $3F10/14/18/1C mirror $3F00/04/08/0C
+    for (int i = 0; i < 32; i++) {
+        palette[i] = ppu.peekVram(static_cast<u16>(0x3F00 + i));
+    }
+    std::memcpy(oam.data(), ppu.getOam(), oam.size());
+    for (int i = 0; i < 4; i++) {
+        std::memcpy(nametables[i].data(), ppu.getNametablePage(i), nametables[i].size());
+    }
+
+    // Through the mapper's bank pointers, so no MMC2 latch is triggered
+    const Mapper* mapper = bus.cartridge.getMapper();
+    for (int bank = 0; bank < 8; bank++) {
+        u8* out = chr.data() + bank * 0x400;
+        const u8* src = mapper ? mapper->getChrBanks()[bank] : nullptr;
+        if (src) {
+            std::memcpy(out, src, 0x400);
+        } else {
+            std::memset(out, 0, 0x400);
+        }
+    }
+
+    chr_generation = bus.cartridge.getChrGeneration();
+    nametable_generation = ppu.getNametableGeneration();
+    palette_generation = ppu.getPaletteGeneration();
+
+    pulse1 = bus.apu.getPulse1Status();
+    pulse2 = bus.apu.getPulse2Status();
+    triangle = bus.apu.getTriangleStatus();
+    noise = bus.apu.getNoiseStatus();
+    dmc = bus.apu.getDMCStatus();
+    frame_counter_mode = bus.apu.getFrameCounterMode();
+    irq_inhibit = bus.apu.getIrqInhibit();
+    apu_irq = bus.apu.isIRQ();
+
+    cartridge_loaded = bus.cartridge.isLoaded();
+    if (cartridge_loaded) {
+        mapper_number = bus.cartridge.getMapperNumber();
+        mapper_name = bus.cartridge.getMapperName();
+        mirroring = bus.cartridge.getMirroring();
+        battery = bus.cartridge.hasBattery();
+        prg_rom_size = bus.cartridge.getPrgRom().size();
+        chr_rom_size = bus.cartridge.getChrRom().size();
+    }
+}
+
+u8 DebugSnapshot::codeByte(u16 addr) const
+{
+    const u16 offset = static_cast<u16>(addr - pc);
+    return offset < CODE_BYTES ? code[offset] : 0;
+}
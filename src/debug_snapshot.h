@@ -0,0 +1,89 @@
+#ifndef DEBUG_SNAPSHOT_H
+#define DEBUG_SNAPSHOT_H
+
+#include "types.h"
+#include "apu.h"
+#include "mapper.h"
+#include <array>
+#include <string>
+
+class Bus;
+
+// What the debug windows show, copied from the machine between two frames.
+// EmuThread captures one after every shown frame and every UI command and
+// hands it over through a triple buffer, so the GUI builds its windows
+// without holding the bus lock.
+struct DebugSnapshot {
+    // The two consecutive pages the memory viewer shows, in CPU or PPU
+    // address space; chosen by the GUI (EmuThread::setMemoryView)
+    struct MemoryView {
+        u8 page = 0;
+        bool ppu = false;
+        bool operator==(const MemoryView&) const = default;
+    };
+
+    static const int CODE_BYTES = 64;   // from PC on, for the disassembly
+
+    void capture(const Bus& bus, MemoryView view);
+
+    // Byte at `addr` if it lies in the code window, else 0
+    u8 codeByte(u16 addr) const;
+
+    // CPU
+    u16 pc = 0;
+    u8 sp = 0;
+    u8 a = 0;
+    u8 x = 0;
+    u8 y = 0;
+    u8 status = 0;
+    u64 cycles = 0;
+    std::array<u8, CODE_BYTES> code{};
+    std::array<u8, 256> stack{};        // page $01
+
+    MemoryView memory_view;
+    std::array<u8, 512> memory{};
+
+    // PPU
+    int scanline = 0;
+    int ppu_cycle = 0;
+    u16 vram_addr = 0;
+    u16 temp_addr = 0;
+    u8 fine_x = 0;
+    bool write_toggle = false;
+    bool frame_complete = false;
+    bool nmi = false;
+    u8 ctrl = 0;
+    u8 mask = 0;
+    u8 ppu_status = 0;
+    std::array<u8, 32> palette{};       // as read at $3F00-$3F1F
+    std::array<u8, 256> oam{};
+    std::array<std::array<u8, 0x400>, 4> nametables{};     // as mirrored
+    std::array<u8, 0x2000> chr{};   // $0000-$1FFF through the current banks
+
+    // Change counters (PPU::getNametableGeneration etc.): the viewers redraw
+    // their images only when these move
+    u32 chr_generation = 0;
+    u32 nametable_generation = 0;
+    u32 palette_generation = 0;
+
+    // APU
+    APU::ChannelStatus pulse1{};
+    APU::ChannelStatus pulse2{};
+    APU::ChannelStatus triangle{};
+    APU::ChannelStatus noise{};
+    APU::ChannelStatus dmc{};
+    u8 frame_counter_mode = 0;
+    bool irq_inhibit = false;
+    bool apu_irq = false;
+
+    // Cartridge
+    bool cartridge_loaded = false;
+    u8 mapper_number = 0;
+    std::string mapper_name;
+    Mirroring mirroring = Mirroring::HORIZONTAL;
+    bool battery = false;
+    size_t prg_rom_size = 0;
+    size_t chr_rom_size = 0;
+};
+
+#endif // DEBUG_SNAPSHOT_H
@@ -1,4 +1,8 @@
 #include "display.h"
+#include "hq2x.h"
+#include "input.h"
+#include "ppu.h"
+#include "profiler.h"
 #include <algorithm>
 #include <cstring>
 #include <type_traits>
@@ -7,10 +11,12 @@ Display::Display(const char* title, Bus& bus, int scale)
 	: gui_(bus)
 	, scale_factor(scale)
 	, escape_pressed(false)
-	, stop_scaler_(false)
-	, scale_requested_(false)
-	, scaled_frame_ready_(false)
 	, gui_texture_was_needed_(false)
+	, gui_built_(false)
+	, ui_scheduler_(NTSC_FRAME_RATE, std::chrono::microseconds(0))
+	, scaler_wake_(0)
+	, stop_scaler_(false)
+	, scaler_threads_(1)
 {
 	window_width = NES_WIDTH * scale_factor;
 	window_height = NES_HEIGHT * scale_factor;
@@ -27,6 +33,8 @@ Display::Display(const char* title, Bus& bus, int scale)
 
 	// Initialize GUI after window creation
 	gui_.initialize(*window);
+	gui_.setScalerThreads(std::min(4, static_cast<int>(std::thread::hardware_concurrency() / 2)));
+
 	texture = std::make_unique<sf::Texture>(sf::Vector2u{ SCALED_WIDTH, SCALED_HEIGHT });
 	sprite = std::make_unique<sf::Sprite>(*texture);
 	sprite->setScale(sf::Vector2f{
@@ -34,45 +42,65 @@ Display::Display(const char* title, Bus& bus, int scale)
 		 static_cast<float>(window_height) / static_cast<float>(SCALED_HEIGHT)
 	});
 
-	// Allocate pixel buffer (RGBA format)
-	pixels.resize(SCALED_WIDTH * SCALED_HEIGHT * 4);
-	scaled_framebuffer.resize(SCALED_WIDTH * SCALED_HEIGHT);
-	pending_framebuffer_.resize(NES_WIDTH * NES_HEIGHT);
-	completed_pixels_.resize(SCALED_WIDTH * SCALED_HEIGHT * 4);
-	completed_scaled_framebuffer_.resize(SCALED_WIDTH * SCALED_HEIGHT);
+	// Frame slots are allocated once; the scaled ones start blank, which is
+	// also the texture until the first frame arrives
+	for (std::vector<u16>& slot : source_frames_.all()) {
+		slot.assign(NES_WIDTH * NES_HEIGHT, 0);
+	}
+	for (std::vector<u32>& slot : scaled_frames_.all()) {
+		slot.assign(SCALED_WIDTH * SCALED_HEIGHT, 0xFF000000);
+	}
+	texture->update(reinterpret_cast<const u8*>(scaled_frames_.front().data()));
 
-	sf::Image img(sf::Vector2u{ static_cast<unsigned int>(SCALED_WIDTH), static_cast<unsigned int>(SCALED_HEIGHT) }, pixels.data());
-	[[maybe_unused]] bool loaded = texture->loadFromImage(img);
+	// 0xAARRGGBB -> 0xAABBGGRR, i.e. R, G, B, A bytes in memory (little
+	// endian) as sf::Texture::update expects; the scaler then writes
+	// texture-ready pixels
+	const u32* argb = PPU::getArgbTable();
+	rgba_palette_.resize(NES_COLOR_COUNT);
+	for (int i = 0; i < NES_COLOR_COUNT; i++) {
+		const u32 color = argb[i];
+		rgba_palette_[i] = (color & 0xFF00FF00) | ((color >> 16) & 0xFF) | ((color & 0xFF) << 16);
+	}
 
 	scaler_thread_ = std::thread(&Display::scalerThreadLoop, this);
 }
 
 Display::~Display()
 {
-	{
-		std::lock_guard<std::mutex> lock(scaler_mutex_);
-		stop_scaler_ = true;
-	}
-
-	scaler_cv_.notify_one();
+	stop_scaler_ = true;
+	wakeScaler();
 	if (scaler_thread_.joinable()) {
 		scaler_thread_.join();
 	}
 }
 
-void Display::update(const u32* framebuffer)
+u16* Display::submitFrame()
+{
+	// Called from the emulation thread: scaler settings are synced by update()
+	source_frames_.publish();
+	wakeScaler();
+	return source_frames_.back().data();
+}
+
+void Display::update()
 {
-	queueFrame(framebuffer);
-	const bool hasNewFrame = consumeScaledFrame();
+	// A new scaler setting rescales the last frame, e.g. while paused
+	if (syncScalerSettings()) {
+		wakeScaler();
+	}
+
+	const bool hasNewFrame = scaled_frames_.take();
+	const u8* pixels = reinterpret_cast<const u8*>(scaled_frames_.front().data());
 	if (hasNewFrame) {
-		sf::Image img(sf::Vector2u{ static_cast<unsigned int>(SCALED_WIDTH), static_cast<unsigned int>(SCALED_HEIGHT) }, pixels.data());
-		[[maybe_unused]] bool loaded = texture->loadFromImage(img);
+		VNES_PROFILE_SCOPE(ProfileStage::TextureUpload);
+		texture->update(pixels);
 	}
 
 	// Only update the GUI's emulator texture when the window is actually visible
 	const bool needsGuiTexture = gui_.needsEmulatorTextureUpdate();
 	if (needsGuiTexture && (hasNewFrame || !gui_texture_was_needed_)) {
-		gui_.updateEmulatorTexture(scaled_framebuffer.data(), SCALED_WIDTH, SCALED_HEIGHT);
+		VNES_PROFILE_SCOPE(ProfileStage::TextureUpload);
+		gui_.updateEmulatorTexture(pixels, SCALED_WIDTH, SCALED_HEIGHT);
 	}
 	gui_texture_was_needed_ = needsGuiTexture;
 
@@ -123,81 +151,112 @@ void Display::pollEvents()
 	}
 }
 
+u8 Display::readController() const
+{
+	u8 state = 0;
+
+	// Map keyboard to NES controller
+	// Arrow keys for D-pad
+	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Up))    state |= Input::BUTTON_UP;
+	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Down))  state |= Input::BUTTON_DOWN;
+	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Left))  state |= Input::BUTTON_LEFT;
+	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Right)) state |= Input::BUTTON_RIGHT;
+
+	// Z/J = A, X/K = B (multiple bindings to avoid ghosting)
+	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Z) ||
+		sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Space)) state |= Input::BUTTON_A;
+	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::X) ||
+		sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LShift)) state |= Input::BUTTON_B;
+
+	// Enter = Start, RShift = Select
+	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Enter)) state |= Input::BUTTON_START;
+	if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RShift)) state |= Input::BUTTON_SELECT;
+
+	return state;
+}
+
+bool Display::isRewindHeld() const
+{
+	if (gui_.isMenuVisible() && ImGui::GetIO().WantCaptureKeyboard) return false;
+	return sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Backspace);
+}
+
+bool Display::isTurboHeld() const
+{
+	if (gui_.isMenuVisible() && ImGui::GetIO().WantCaptureKeyboard) return false;
+	return sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Tab);
+}
+
+void Display::buildGui()
+{
+	// Only while the menu or an overlay is visible
+	if (gui_.isVisible()) {
+		gui_.update(*window, clock.restart().asSeconds());
+		gui_.build();
+		gui_built_ = true;
+	}
+}
+
 void Display::present()
 {
-	// Update and render GUI only if menu is visible, then present the window contents and handle frame timing
-	float elapsed = clock.getElapsedTime().asSeconds();
-	if (gui_.isMenuVisible()) {
-		gui_.update(*window, elapsed);
+	// Draw the GUI if it was built, then present the window contents and handle frame timing
+	if (gui_built_) {
 		gui_.render(*window);
+		gui_built_ = false;
 	}
 
 	window->display();
 
-	// Frame timing - wait until target frame time has elapsed
-	if (elapsed < TARGET_FRAME_TIME) {
-		sf::sleep(sf::seconds(TARGET_FRAME_TIME - elapsed));
-	}
-	clock.restart();
+	// The UI runs at the NTSC frame rate on absolute deadlines; it only
+	// sleeps, the emulation thread does the precise waiting
+	ui_scheduler_.wait();
 }
 
 void Display::scalerThreadLoop()
 {
-	std::vector<u32> source_framebuffer(NES_WIDTH * NES_HEIGHT);
-	std::vector<u32> scaled_output(SCALED_WIDTH * SCALED_HEIGHT);
-	std::vector<u8> pixel_output(SCALED_WIDTH * SCALED_HEIGHT * 4);
+	HQ2x scaler;
+	scaler.setRgbaPalette(true);
+	bool has_frame = false;
+	unsigned wake = 0;
 
 	for (;;) {
-		{
-			std::unique_lock<std::mutex> lock(scaler_mutex_);
-			scaler_cv_.wait(lock, [this] { return stop_scaler_ || scale_requested_; });
-			if (stop_scaler_) {
-				return;
-			}
-
-			source_framebuffer = pending_framebuffer_;
-			scale_requested_ = false;
+		scaler_wake_.wait(wake);
+		wake = scaler_wake_.load();
+		if (stop_scaler_) {
+			return;
 		}
 
-		scaler_.resize(source_framebuffer.data(), NES_WIDTH, NES_HEIGHT, scaled_output.data());
-
-		for (int i = 0; i < SCALED_WIDTH * SCALED_HEIGHT; i++) {
-			const u32 color = scaled_output[i];
-			pixel_output[i * 4 + 0] = static_cast<u8>((color >> 16) & 0xFF);
-			pixel_output[i * 4 + 1] = static_cast<u8>((color >> 8) & 0xFF);
-			pixel_output[i * 4 + 2] = static_cast<u8>(color & 0xFF);
-			pixel_output[i * 4 + 3] = static_cast<u8>((color >> 24) & 0xFF);
+		// Without a new frame this is a settings change: rescale the last one
+		if (source_frames_.take()) {
+			has_frame = true;
 		}
-
-		{
-			std::lock_guard<std::mutex> lock(scaler_mutex_);
-			completed_scaled_framebuffer_.swap(scaled_output);
-			completed_pixels_.swap(pixel_output);
-			scaled_frame_ready_ = true;
+		if (!has_frame) {
+			continue;
 		}
-	}
-}
 
-void Display::queueFrame(const u32* framebuffer)
-{
-	{
-		std::lock_guard<std::mutex> lock(scaler_mutex_);
-		std::copy_n(framebuffer, NES_WIDTH * NES_HEIGHT, pending_framebuffer_.begin());
-		scale_requested_ = true;
-	}
+		VNES_PROFILE_SCOPE(ProfileStage::Scaler);
+		std::vector<u32>& pixels = scaled_frames_.back();
+		scaler.setThreadCount(static_cast<unsigned>(scaler_threads_.load()));
+		scaler.resizeIndexed(source_frames_.front().data(), rgba_palette_.data(), NES_COLOR_COUNT,
+			NES_WIDTH, NES_HEIGHT, pixels.data());
 
-	scaler_cv_.notify_one();
+		scaled_frames_.publish();
+	}
 }
 
-bool Display::consumeScaledFrame()
+bool Display::syncScalerSettings()
 {
-	std::lock_guard<std::mutex> lock(scaler_mutex_);
-	if (!scaled_frame_ready_) {
+	const int threads = gui_.getScalerThreads();
+	if (threads == scaler_threads_) {
 		return false;
 	}
 
-	scaled_framebuffer.swap(completed_scaled_framebuffer_);
-	pixels.swap(completed_pixels_);
-	scaled_frame_ready_ = false;
+	scaler_threads_ = threads;
 	return true;
 }
+
+void Display::wakeScaler()
+{
+	scaler_wake_.fetch_add(1);
+	scaler_wake_.notify_one();
+}
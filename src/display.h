@@ -3,13 +3,13 @@
 
 #include "types.h"
 #include <SFML/Graphics.hpp>
-#include <condition_variable>
-#include <mutex>
+#include <atomic>
 #include <memory>
 #include <thread>
 #include <vector>
+#include "frame_scheduler.h"
 #include "gui.h"
-#include "hq2x.h"
+#include "triple_buffer.h"
 
 class PPU;
 class Bus;
@@ -19,8 +19,16 @@ public:
     Display(const char* title, Bus& bus, int scale = 3);
     ~Display();
 
-    // Update display with PPU framebuffer
-    void update(const u32* framebuffer);
+    // Frames travel through lock-free rings without copies: the PPU renders
+    // straight into getFrameSlot() (see PPU::setFramebuffer), submitFrame()
+    // hands that slot to the scaler thread and returns the slot to render the
+    // next frame into, and the scaler writes RGBA into a slot the texture is
+    // updated from.
+    u16* getFrameSlot() { return source_frames_.back().data(); }
+    u16* submitFrame();
+
+    // Upload the newest scaled frame, if any, and draw it
+    void update();
 
     // Check if window should close
     bool isOpen() const;
@@ -31,6 +39,15 @@ public:
     // Process window events
     void pollEvents();
 
+    // Sample the keyboard into an NES controller bitmask (Input::Button)
+    u8 readController() const;
+
+    // True while the rewind key (Backspace) is held outside ImGui text input
+    bool isRewindHeld() const;
+
+    // True while the turbo key (Tab) is held outside ImGui text input
+    bool isTurboHeld() const;
+
     // Get window dimensions
     int getWidth() const { return window_width; }
     int getHeight() const { return window_height; }
@@ -38,7 +55,13 @@ public:
     // Expose the SFML window for GUI integration
     sf::RenderWindow& getWindow() { return *window; }
 
-    // Present the GUI and window contents (call after drawing)
+    // Start a GUI frame and build its windows if the menu or an overlay is
+    // visible. The debug windows read the snapshot set with
+    // Gui::setDebugSnapshot, never the Bus.
+    void buildGui();
+
+    // Draw the GUI built this frame and present the window contents (call
+    // after drawing; no bus access)
     void present();
 
     // Retrieve Game Genie code submitted via GUI
@@ -50,42 +73,44 @@ public:
     // Check if emulator screen is being rendered in a window
     bool isEmulatorInGuiWindow() const { return gui_.isEmulatorInWindow(); }
 
+    // Threads the scaler splits each frame across (also in the View menu);
+    // the default is half the host's cores, at most 4
+    void setScalerThreads(int threads) { gui_.setScalerThreads(threads); }
+    int getScalerThreads() const { return gui_.getScalerThreads(); }
+
 private:
     void scalerThreadLoop();
-    void queueFrame(const u32* framebuffer);
-    bool consumeScaledFrame();
+    bool syncScalerSettings();
+    void wakeScaler();
 
     static const int NES_WIDTH = 256;
     static const int NES_HEIGHT = 240;
     static const int HQ2X_SCALE = 2;
-    static const int SCALED_WIDTH = NES_WIDTH * HQ2X_SCALE;
-    static const int SCALED_HEIGHT = NES_HEIGHT * HQ2X_SCALE;
+    static const unsigned SCALED_WIDTH = NES_WIDTH * HQ2X_SCALE;
+    static const unsigned SCALED_HEIGHT = NES_HEIGHT * HQ2X_SCALE;
 
     std::unique_ptr<sf::RenderWindow> window;
     std::unique_ptr<sf::Texture> texture;
     std::unique_ptr<sf::Sprite> sprite;
-    std::vector<u8> pixels;
-    std::vector<u32> scaled_framebuffer;
-    std::vector<u32> pending_framebuffer_;
-    std::vector<u8> completed_pixels_;
-    std::vector<u32> completed_scaled_framebuffer_;
-    sf::Clock clock;
+    TripleBuffer<std::vector<u16>> source_frames_;    // emulation -> scaler
+    TripleBuffer<std::vector<u32>> scaled_frames_;     // scaler -> main thread, RGBA
+    std::vector<u32> rgba_palette_;  // PPU::getArgbTable() in texture byte order
+    sf::Clock clock;                // GUI frame delta time
     Gui gui_;
-    HQ2x scaler_;
     std::thread scaler_thread_;
-    std::mutex scaler_mutex_;
-    std::condition_variable scaler_cv_;
 
     int window_width;
     int window_height;
     int scale_factor;
     bool escape_pressed;
-    bool stop_scaler_;
-    bool scale_requested_;
-    bool scaled_frame_ready_;
     bool gui_texture_was_needed_;
+    bool gui_built_;                // buildGui() ran since the last present()
+    FrameScheduler ui_scheduler_;
 
-    static constexpr float TARGET_FRAME_TIME = 1.0f / 60.0f; // 60 FPS
+    // Scaler thread control; the settings are copied from the GUI
+    std::atomic<unsigned> scaler_wake_;     // bumped for each request
+    std::atomic<bool> stop_scaler_;
+    std::atomic<int> scaler_threads_;
 };
 
 #endif // DISPLAY_H
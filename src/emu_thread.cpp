@@ -0,0 +1,298 @@
+#include "emu_thread.h"
+#include "bus.h"
+#include "display.h"
+#include <algorithm>
+
+EmuThread::EmuThread(Bus& bus, Display& display)
+    : bus_(bus)
+    , display_(display)
+    , scheduler_(NTSC_FRAME_RATE)
+    , memory_view_(DebugSnapshot::MemoryView{})
+    , stop_(false)
+    , rom_loaded_(false)
+    , paused_(false)
+    , rewind_held_(false)
+    , controller_(0)
+    , run_ahead_frames_(0)
+    , speed_(1)
+    , lock_waiters_(0)
+    , current_speed_(1)
+    , frames_run_(0)
+    , rate_frames_(0)
+    , emulation_rate_(0.0)
+    , newest_is_current_(false)
+{
+    // The PPU renders straight into the display's frame ring
+    bus_.ppu.setFramebuffer(display_.getFrameSlot());
+}
+
+EmuThread::~EmuThread()
+{
+    stop();
+}
+
+void EmuThread::start()
+{
+    stop_ = false;
+    thread_ = std::thread(&EmuThread::threadLoop, this);
+}
+
+void EmuThread::stop()
+{
+    stop_ = true;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void EmuThread::threadLoop()
+{
+    scheduler_.restart();
+    rate_start_ = FrameScheduler::Clock::now();
+    bool ran = false;
+    while (!stop_) {
+        const int speed = speed_.load(std::memory_order_relaxed);
+        if (speed != current_speed_) {
+            current_speed_ = speed;
+            scheduler_.setFrameRate(NTSC_FRAME_RATE * std::max(speed, 1));
+            frames_run_ = 0;
+        }
+
+        // Unlimited speed only waits while there is nothing to emulate
+        if (current_speed_ != UNLIMITED_SPEED || !ran) {
+            scheduler_.wait();
+        }
+        ran = emulateFrame();
+        if (ran) {
+            rate_frames_++;
+        }
+        else if (memory_view_.load(std::memory_order_relaxed) != idle_view_) {
+            // Nothing changes the machine while idle, but the memory viewer
+            // can move to other pages
+            idle_view_ = memory_view_.load(std::memory_order_relaxed);
+            std::lock_guard<std::mutex> lock(bus_mutex_);
+            publishDebugSnapshot();
+        }
+        updateEmulationRate();
+
+        PacingStats& stats = pacing_stats_.back();
+        scheduler_.getStats(stats);
+        stats.emulation_rate = emulation_rate_;
+        pacing_stats_.publish();
+
+        while (lock_waiters_.load() > 0) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void EmuThread::updateEmulationRate()
+{
+    const auto now = FrameScheduler::Clock::now();
+    const double elapsed = std::chrono::duration<double>(now - rate_start_).count();
+    if (elapsed < 0.5) return;
+
+    emulation_rate_ = static_cast<double>(rate_frames_) / elapsed;
+    rate_start_ = now;
+    rate_frames_ = 0;
+}
+
+bool EmuThread::shouldPresent()
+{
+    if (current_speed_ == UNLIMITED_SPEED) {
+        // One frame per NTSC period of wall time
+        const auto now = FrameScheduler::Clock::now();
+        if (now < next_present_) return false;
+
+        const auto period = std::chrono::duration_cast<FrameScheduler::Clock::duration>(
+            std::chrono::duration<double>(1.0 / NTSC_FRAME_RATE));
+        next_present_ += period;
+        if (next_present_ < now) {
+            next_present_ = now + period;
+        }
+        return true;
+    }
+    return frames_run_++ % static_cast<u64>(current_speed_) == 0;
+}
+
+std::unique_lock<std::mutex> EmuThread::lockBus()
+{
+    lock_waiters_.fetch_add(1);
+    std::unique_lock<std::mutex> lock(bus_mutex_);
+    lock_waiters_.fetch_sub(1);
+    return lock;
+}
+
+bool EmuThread::takePacingStats(PacingStats& out)
+{
+    if (!pacing_stats_.take()) return false;
+
+    out = pacing_stats_.front();
+    return true;
+}
+
+const DebugSnapshot& EmuThread::takeDebugSnapshot()
+{
+    debug_snapshots_.take();
+    return debug_snapshots_.front();
+}
+
+void EmuThread::publishDebugSnapshot()
+{
+    debug_snapshots_.back().capture(bus_, memory_view_.load(std::memory_order_relaxed));
+    debug_snapshots_.publish();
+}
+
+bool EmuThread::emulateFrame()
+{
+    if (!rom_loaded_) return false;
+
+    // Rewind also works while paused
+    const bool rewinding = rewind_held_.load(std::memory_order_relaxed);
+    if (!rewinding && paused_.load(std::memory_order_relaxed)) return false;
+
+    std::lock_guard<std::mutex> lock(bus_mutex_);
+    bus_.updateInput(controller_.load(std::memory_order_relaxed));
+
+    if (rewinding) {
+        if (!rewindFrames(1)) return false;
+
+        submitFrame();
+        publishDebugSnapshot();
+        return true;
+    }
+
+    recordFrameStart();
+
+    // In turbo, frames that are not shown are also not heard: their samples
+    // are dropped rather than queued behind the device
+    const bool present = shouldPresent();
+    AudioSink* sink = bus_.apu.getAudioSink();
+    if (!present) {
+        bus_.apu.setAudioSink(nullptr);
+    }
+
+    bus_.runFrame();
+
+    // Notify cartridge that frame is complete (for SRAM auto-save, which
+    // counts emulated frames, so turbo saves sooner in wall time)
+    bus_.cartridge.signalFrameComplete();
+
+    if (!present) {
+        // The PPU draws the next frame over this one; nothing is scaled
+        // or captured for the debug windows
+        bus_.apu.setAudioSink(sink);
+        return true;
+    }
+
+    // Show a frame from further ahead, emulated with this input
+    bus_.runAhead(run_ahead_frames_.load(std::memory_order_relaxed));
+
+    submitFrame();
+    publishDebugSnapshot();
+    return true;
+}
+
+void EmuThread::recordFrameStart()
+{
+    bus_.saveState(rewind_state_);
+    rewind_.push(rewind_state_);
+    newest_is_current_ = true;
+}
+
+bool EmuThread::rewindFrames(int frames)
+{
+    // Re-running the newest snapshot would only repeat the frame just
+    // emulated, so the first step of a rewind drops it
+    if (newest_is_current_) {
+        rewind_.pop(rewind_state_);
+        newest_is_current_ = false;
+    }
+
+    bool popped = false;
+    for (int i = 0; i < frames && rewind_.pop(rewind_state_); i++) {
+        popped = true;
+    }
+    if (!popped || !bus_.loadState(rewind_state_)) return false;
+
+    AudioSink* sink = bus_.apu.getAudioSink();
+    bus_.apu.setAudioSink(nullptr);
+    bus_.runFrame();
+    bus_.apu.setAudioSink(sink);
+    return true;
+}
+
+void EmuThread::submitFrame()
+{
+    // Hand the finished frame to the scaler and render the next one into a
+    // free slot
+    bus_.ppu.setFramebuffer(display_.submitFrame());
+}
+
+bool EmuThread::loadRom(const std::string& path)
+{
+    auto lock = lockBus();
+    const bool loaded = bus_.loadCartridge(path);
+    if (loaded) {
+        bus_.reset();
+        rewind_.clear();
+        newest_is_current_ = false;
+    }
+    rom_loaded_ = loaded;
+    publishDebugSnapshot();
+    return loaded;
+}
+
+void EmuThread::reset()
+{
+    auto lock = lockBus();
+    if (rom_loaded_) {
+        bus_.reset();
+        publishDebugSnapshot();
+    }
+}
+
+void EmuThread::step()
+{
+    auto lock = lockBus();
+    if (rom_loaded_) {
+        bus_.clock();
+        publishDebugSnapshot();
+    }
+}
+
+void EmuThread::stepFrame()
+{
+    auto lock = lockBus();
+    if (rom_loaded_) {
+        recordFrameStart();
+        bus_.runFrame();
+        submitFrame();
+        publishDebugSnapshot();
+    }
+}
+
+bool EmuThread::rewind(int frames)
+{
+    auto lock = lockBus();
+    if (!rom_loaded_ || !rewindFrames(frames)) return false;
+
+    submitFrame();
+    publishDebugSnapshot();
+    return true;
+}
+
+bool EmuThread::addGameGenieCode(const std::string& code)
+{
+    auto lock = lockBus();
+    const bool added = bus_.cartridge.addGGCode(code);
+    publishDebugSnapshot();
+    return added;
+}
+
+void EmuThread::runCommand(const std::function<void()>& command)
+{
+    auto lock = lockBus();
+    command();
+    publishDebugSnapshot();
+}
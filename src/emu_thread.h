@@ -0,0 +1,154 @@
+#ifndef EMU_THREAD_H
+#define EMU_THREAD_H
+
+#include "types.h"
+#include "debug_snapshot.h"
+#include "frame_scheduler.h"
+#include "rewind.h"
+#include "triple_buffer.h"
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Bus;
+class Display;
+
+// Runs the emulated machine on its own thread, one frame per NTSC frame
+// period (FrameScheduler), so a slow UI frame (debug viewers, window
+// drags, vsync) no longer holds back emulation or audio.
+//
+// The UI thread reaches it four ways:
+//  - controller state, pause, rewind key, run-ahead, speed and the memory
+//    viewer's pages are atomics the thread samples at the start of every
+//    frame;
+//  - finished frames go straight to the display's triple buffer
+//    (Display::submitFrame);
+//  - the debug windows read a DebugSnapshot, captured between two frames
+//    after every shown frame and every command, so building them never
+//    waits for the machine;
+//  - commands that change the Bus (step, rewind, Game Genie, console...)
+//    run under the bus lock, which the thread holds only while it emulates
+//    a frame.
+class EmuThread {
+public:
+    EmuThread(Bus& bus, Display& display);
+    ~EmuThread();
+
+    EmuThread(const EmuThread&) = delete;
+    EmuThread& operator=(const EmuThread&) = delete;
+
+    void start();
+    void stop();
+
+    // Sampled at the start of every frame
+    void setController(u8 buttons) { controller_.store(buttons, std::memory_order_relaxed); }
+    void setRewindHeld(bool held) { rewind_held_.store(held, std::memory_order_relaxed); }
+    void setPaused(bool paused) { paused_.store(paused, std::memory_order_relaxed); }
+    void setRunAheadFrames(int frames) { run_ahead_frames_.store(frames, std::memory_order_relaxed); }
+
+    // Turbo: emulate `speed` frames per NTSC frame period (1 is normal
+    // speed), or as fast as possible with UNLIMITED_SPEED. Only about one
+    // frame per period reaches the display and the audio device; the others
+    // skip scaling, run-ahead and sound.
+    static const int UNLIMITED_SPEED = 0;
+    void setSpeed(int speed) { speed_.store(speed, std::memory_order_relaxed); }
+
+    // Newest frame pacing statistics (timing fields only); false if none
+    // were published since the last call
+    bool takePacingStats(PacingStats& out);
+
+    // Pages the memory viewer shows, included in every debug snapshot. While
+    // paused a change is captured on its own.
+    void setMemoryView(DebugSnapshot::MemoryView view) { memory_view_.store(view, std::memory_order_relaxed); }
+
+    // Newest debug snapshot; stays valid until the next call
+    const DebugSnapshot& takeDebugSnapshot();
+
+    // UI commands; each takes the bus lock and publishes a debug snapshot of
+    // the result. loadRom also clears the rewind history and leaves the
+    // machine stopped if the ROM fails to load. runCommand runs anything else
+    // that reads or changes the Bus, e.g. a debugger console command.
+    bool loadRom(const std::string& path);
+    bool isRomLoaded() const { return rom_loaded_.load(); }
+    void reset();
+    void step();            // one CPU instruction
+    void stepFrame();
+    bool rewind(int frames);
+    bool addGameGenieCode(const std::string& code);
+    void runCommand(const std::function<void()>& command);
+
+private:
+    void threadLoop();
+
+    // Lock the Bus to change it from the UI thread. The emulation thread
+    // holds the lock while it emulates a frame and steps aside between frames
+    // while anyone is waiting for it, which matters at unlimited speed where
+    // it never sleeps.
+    std::unique_lock<std::mutex> lockBus();
+
+    // With the bus lock held: capture the machine for the debug windows
+    void publishDebugSnapshot();
+
+    // Emulate one frame if there is one to emulate; false when stopped,
+    // paused or out of rewind history
+    bool emulateFrame();
+
+    // Whether the frame about to run goes to the display and the audio
+    // device at the current speed
+    bool shouldPresent();
+    void updateEmulationRate();
+
+    // With the bus lock held: snapshot the machine into the rewind history
+    // before emulating a frame
+    void recordFrameStart();
+
+    // With the bus lock held: step back `frames` states and re-run the oldest
+    // one, muted, so its picture is shown (false if there was no history),
+    // and hand the PPU's frame to the display
+    bool rewindFrames(int frames);
+    void submitFrame();
+
+    Bus& bus_;
+    Display& display_;
+    std::thread thread_;
+    std::mutex bus_mutex_;
+
+    // Frame deadlines (emulation thread) and their statistics, published
+    // to the UI thread once per frame
+    FrameScheduler scheduler_;
+    TripleBuffer<PacingStats> pacing_stats_;
+
+    // Debug windows' view of the machine, produced under the bus lock (the
+    // emulation thread, or a UI command) and consumed by the UI thread
+    TripleBuffer<DebugSnapshot> debug_snapshots_;
+    std::atomic<DebugSnapshot::MemoryView> memory_view_;
+    DebugSnapshot::MemoryView idle_view_;  // emulation thread: last captured while idle
+
+    std::atomic<bool> stop_;
+    std::atomic<bool> rom_loaded_;
+    std::atomic<bool> paused_;
+    std::atomic<bool> rewind_held_;
+    std::atomic<u8> controller_;
+    std::atomic<int> run_ahead_frames_;
+    std::atomic<int> speed_;
+    std::atomic<int> lock_waiters_;
+
+    // Turbo bookkeeping (emulation thread)
+    int current_speed_;
+    u64 frames_run_;
+    FrameScheduler::Clock::time_point next_present_;
+    FrameScheduler::Clock::time_point rate_start_;
+    u64 rate_frames_;
+    double emulation_rate_;
+
+    // Rewind history, one snapshot per emulated frame (bus lock). The newest
+    // is the start of the last frame emulated until a rewind drops it.
+    RewindBuffer rewind_;
+    std::vector<u8> rewind_state_;
+    bool newest_is_current_;
+};
+
+#endif // EMU_THREAD_H
@@ -0,0 +1,104 @@
+#include "frame_scheduler.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+FrameScheduler::FrameScheduler(double frameRate, std::chrono::microseconds maxSpin)
+    : frame_rate(frameRate)
+    , period_ns(1e9 / frameRate)
+    , max_spin(maxSpin)
+    , spin_margin(maxSpin)
+    , oversleep_ns(0.0)
+    , start(Clock::now())
+    , frame(0)
+    , resyncs(0)
+    , lateness_us{}
+    , head(0)
+    , count(0)
+{
+}
+
+void FrameScheduler::setFrameRate(double frameRate)
+{
+    frame_rate = frameRate;
+    period_ns = 1e9 / frameRate;
+    restart();
+}
+
+void FrameScheduler::restart()
+{
+    start = Clock::now();
+    frame = 0;
+}
+
+void FrameScheduler::wait()
+{
+    frame++;
+    const auto offset = std::chrono::nanoseconds(std::llround(static_cast<double>(frame) * period_ns));
+    const Clock::time_point deadline = start + std::chrono::duration_cast<Clock::duration>(offset);
+
+    Clock::time_point now = Clock::now();
+    const auto maxLag = std::chrono::nanoseconds(std::llround(period_ns * MAX_LAG_FRAMES));
+    if (now - deadline > maxLag) {
+        // Too far behind to catch up: this frame starts a new schedule
+        resyncs++;
+        restart();
+        record(Clock::duration::zero());
+        return;
+    }
+
+    // Sleep through most of the wait. The overshoot of each sleep sets how
+    // early the next one ends: twice its running average, within max_spin
+    const Clock::time_point wake = deadline - spin_margin;
+    if (now < wake) {
+        std::this_thread::sleep_until(wake);
+        now = Clock::now();
+
+        const double overshoot = std::chrono::duration<double, std::nano>(now - wake).count();
+        oversleep_ns += (overshoot - oversleep_ns) / 16.0;
+        const auto margin = std::chrono::nanoseconds(std::llround(oversleep_ns * 2.0));
+        spin_margin = std::min(max_spin, std::chrono::duration_cast<Clock::duration>(margin));
+    }
+
+    while (now < deadline) {
+        std::this_thread::yield();
+        now = Clock::now();
+    }
+
+    record(now - deadline);
+}
+
+void FrameScheduler::record(Clock::duration lateness)
+{
+    lateness_us[head] = std::chrono::duration<float, std::micro>(lateness).count();
+    head = (head + 1) % PacingStats::HISTORY;
+    count = std::min(count + 1, PacingStats::HISTORY);
+}
+
+void FrameScheduler::getStats(PacingStats& out) const
+{
+    out.lateness_us = lateness_us;
+    out.head = count < PacingStats::HISTORY ? 0 : head;
+    out.count = count;
+
+    double sum = 0.0;
+    double squares = 0.0;
+    float peak = 0.0f;
+    for (size_t i = 0; i < count; i++) {
+        sum += lateness_us[i];
+        squares += static_cast<double>(lateness_us[i]) * lateness_us[i];
+        peak = std::max(peak, lateness_us[i]);
+    }
+    const double mean = count ? sum / static_cast<double>(count) : 0.0;
+    const double variance = count ? squares / static_cast<double>(count) - mean * mean : 0.0;
+
+    out.mean_us = static_cast<float>(mean);
+    out.stddev_us = static_cast<float>(std::sqrt(std::max(variance, 0.0)));
+    out.max_us = peak;
+    out.spin_margin_us = std::chrono::duration<float, std::micro>(spin_margin).count();
+    out.target_rate = frame_rate;
+    out.resyncs = resyncs;
+
+    const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    out.measured_rate = (frame > 0 && elapsed > 0.0) ? static_cast<double>(frame) / elapsed : 0.0;
+}
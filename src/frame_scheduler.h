@@ -0,0 +1,88 @@
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#include "types.h"
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+// NTSC: 1789772.73 Hz CPU clock over 29780.5 cycles per frame
+static constexpr double NTSC_FRAME_RATE = 60.0988138974405;
+
+// Frame pacing statistics, as shown in Debug -> Performance. The emulation
+// rate comes from EmuThread and the audio fields are filled in by the
+// frontend from its sound device.
+struct PacingStats {
+    static const size_t HISTORY = 240;
+
+    // Wake-up lateness past each deadline in microseconds; a ring whose
+    // oldest entry is at `head` once `count` reaches HISTORY
+    std::array<float, HISTORY> lateness_us{};
+    size_t head = 0;
+    size_t count = 0;
+
+    float mean_us = 0.0f;           // over the history
+    float stddev_us = 0.0f;
+    float max_us = 0.0f;
+    float spin_margin_us = 0.0f;    // current sleep-then-spin split
+    double target_rate = 0.0;       // frames per second
+    double measured_rate = 0.0;     // since the schedule (re)started
+    u32 resyncs = 0;                // schedule restarts after falling behind
+    double emulation_rate = 0.0;    // emulated frames per second (turbo)
+
+    size_t audio_buffered = 0;      // samples queued for the audio device
+    size_t audio_target = 0;
+    double audio_rate_scale = 1.0;  // dynamic resampling ratio
+};
+
+// Absolute-deadline frame scheduler.
+//
+// Deadline n is start + n * period, computed from the frame count instead of
+// adding a rounded period every frame, so the rate does not drift. wait()
+// sleeps until shortly before the deadline and spins (yielding) through the
+// rest: OS sleeps overshoot, and the spin margin follows the overshoot
+// measured on earlier sleeps, up to `maxSpin`. A deadline missed by more
+// than MAX_LAG_FRAMES periods restarts the schedule rather than running the
+// missed frames back to back.
+class FrameScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static const int MAX_LAG_FRAMES = 4;
+    static constexpr std::chrono::microseconds DEFAULT_MAX_SPIN{2000};
+
+    explicit FrameScheduler(double frameRate, std::chrono::microseconds maxSpin = DEFAULT_MAX_SPIN);
+
+    // Change the rate; the schedule restarts from now
+    void setFrameRate(double frameRate);
+    double getFrameRate() const { return frame_rate; }
+
+    // Restart the schedule from now (e.g. after a pause)
+    void restart();
+
+    // Block until the next frame's deadline
+    void wait();
+
+    // Copy the timing statistics into `out` (emulation rate and audio fields
+    // untouched)
+    void getStats(PacingStats& out) const;
+
+private:
+    void record(Clock::duration lateness);
+
+    double frame_rate;
+    double period_ns;
+    Clock::duration max_spin;
+    Clock::duration spin_margin;
+    double oversleep_ns;            // running average of sleep overshoot
+
+    Clock::time_point start;
+    u64 frame;                      // deadlines since `start`
+    u32 resyncs;
+
+    std::array<float, PacingStats::HISTORY> lateness_us;
+    size_t head;
+    size_t count;
+};
+
+#endif // FRAME_SCHEDULER_H
@@ -1,10 +1,6 @@
 #include "gui.h"
-#include "bus.h"
-#include "cpu.h"
-#include "ppu.h"
-#include "apu.h"
-#include "cartridge.h"
 #include "disasm.h"
+#include "profiler.h"
 #include <imgui.h>
 #include <ImGui-SFML.h>
 #include <SFML/Graphics.hpp>
@@ -17,9 +13,11 @@
 
 using namespace vnes::disasm;
 
+// Shown until the emulation thread publishes the first snapshot
+static const DebugSnapshot emptySnapshot;
+
 Gui::Gui(Bus& bus) 
-    : bus_(bus)
-    , console_(bus)
+    : console_(bus)
     , menuVisible_(false)
     , paused_(false)
     , showCpuDebugger_(false)
@@ -35,10 +33,17 @@ Gui::Gui(Bus& bus)
     , showEmulatorWindow_(false)
     , showFileDialog_(false)
     , showConsole_(false)
+    , showPerformance_(false)
     , ggSubmitted_(false)
     , memoryViewAddress_(0)
     , memoryViewType_(0)
     , patternTablePalette_(0)
+    , scalerThreads_(1)
+    , runAheadFrames_(0)
+    , turboEnabled_(false)
+    , turboSpeed_(4)
+    , turboActive_(false)
+    , snapshot_(&emptySnapshot)
     , emulatorTextureInitialized_(false)
     , selectedFileIndex_(-1)
 {
@@ -68,6 +73,12 @@ void Gui::initialize(sf::RenderWindow& window) {
     // Initialize emulator texture
     emulatorTexture_ = sf::Texture(sf::Vector2u{256, 240});
     emulatorTextureInitialized_ = true;
+
+    // Debug viewers: both pattern tables side by side, all four nametables
+    patternTexture_ = sf::Texture(sf::Vector2u{256, 128});
+    patternPixels_.assign(256 * 128, 0);
+    nametableTexture_ = sf::Texture(sf::Vector2u{512, 480});
+    nametablePixels_.assign(512 * 480, 0);
 }
 
 void Gui::processEvent(sf::RenderWindow& window, const sf::Event& event) {
@@ -78,25 +89,14 @@ void Gui::update(sf::RenderWindow& window, float dt) {
     ImGui::SFML::Update(window, sf::seconds(dt));
 }
 
-void Gui::updateEmulatorTexture(const u32* framebuffer, unsigned width, unsigned height) {
+void Gui::updateEmulatorTexture(const u8* pixels, unsigned width, unsigned height) {
     if (!emulatorTextureInitialized_) return;
 
     if (emulatorTexture_.getSize().x != width || emulatorTexture_.getSize().y != height) {
         emulatorTexture_ = sf::Texture(sf::Vector2u{ width, height });
     }
 
-    // Convert framebuffer to RGBA
-    std::vector<u8> pixels(width * height * 4);
-    for (unsigned i = 0; i < width * height; i++) {
-        u32 color = framebuffer[i];
-        pixels[i * 4 + 0] = static_cast<u8>((color >> 16) & 0xFF);  // R
-        pixels[i * 4 + 1] = static_cast<u8>((color >> 8) & 0xFF);   // G
-        pixels[i * 4 + 2] = static_cast<u8>(color & 0xFF);          // B
-        pixels[i * 4 + 3] = 255;  // A
-    }
-
-    sf::Image img(sf::Vector2u{ width, height }, pixels.data());
-    [[maybe_unused]] bool loaded = emulatorTexture_.loadFromImage(img);
+    emulatorTexture_.update(pixels);
 }
 
 ImU32 Gui::nesColorToImU32(u8 colorIndex) const {
@@ -104,15 +104,39 @@ ImU32 Gui::nesColorToImU32(u8 colorIndex) const {
     return IM_COL32((c >> 16) & 0xFF, (c >> 8) & 0xFF, c & 0xFF, 255);
 }
 
+Gui::ViewerKey Gui::makeViewerKey(int option) const {
+    ViewerKey key;
+    key.chr = snapshot_->chr_generation;
+    key.nametables = snapshot_->nametable_generation;
+    key.palette = snapshot_->palette_generation;
+    key.option = option;
+    return key;
+}
+
+void Gui::decodeTile(u32* out, int stride, u16 tileAddr, const u32* colors) const {
+    const u8* tile = snapshot_->chr.data() + (tileAddr & 0x1FF0);
+
+    for (int row = 0; row < 8; row++) {
+        u8 lo = tile[row];
+        u8 hi = tile[row + 8];
+
+        for (int col = 0; col < 8; col++) {
+            u8 bit = 7 - col;
+            u8 pixel = ((lo >> bit) & 1) | (((hi >> bit) & 1) << 1);
+            out[row * stride + col] = colors[pixel];
+        }
+    }
+}
+
 std::string Gui::disassembleInstruction(u16 addr, int& length) {
-    u8 opcode = bus_.read(addr);
+    u8 opcode = snapshot_->codeByte(addr);
     AddrMode mode = addrModes[opcode];
     length = modeLengths[static_cast<int>(mode)];
 
     const char* name = opcodeNames[opcode];
 
-    u8 lo = (length > 1) ? bus_.read(addr + 1) : 0;
-    u8 hi = (length > 2) ? bus_.read(addr + 2) : 0;
+    u8 lo = (length > 1) ? snapshot_->codeByte(addr + 1) : 0;
+    u8 hi = (length > 2) ? snapshot_->codeByte(addr + 2) : 0;
     u16 absAddr = (hi << 8) | lo;
 
     switch (mode) {
@@ -149,7 +173,9 @@ std::string Gui::disassembleInstruction(u16 addr, int& length) {
     }
 }
 
-void Gui::render(sf::RenderWindow& window) {
+void Gui::build() {
+    VNES_PROFILE_SCOPE(ProfileStage::GuiRender);
+
     if (menuVisible_) {
         renderMenuBar();
 
@@ -167,8 +193,15 @@ void Gui::render(sf::RenderWindow& window) {
         if (showEmulatorWindow_) renderEmulatorWindow();
         if (showFileDialog_) renderFileDialog();
         if (showConsole_) renderConsole();
+        if (showPerformance_) renderPerformance();
     }
 
+    // Shown with or without the menu
+    if (turboActive_) renderTurboOverlay();
+}
+
+void Gui::render(sf::RenderWindow& window) {
+    VNES_PROFILE_SCOPE(ProfileStage::GuiRender);
     ImGui::SFML::Render(window);
 }
 
@@ -209,6 +242,27 @@ void Gui::renderMenuBar() {
             if (ImGui::MenuItem("Step Frame", "F8", false, paused_)) {
                 pendingAction_.type = GuiAction::StepFrame;
             }
+            ImGui::Separator();
+            if (ImGui::MenuItem("Rewind 1 Second", "Backspace")) {
+                pendingAction_.type = GuiAction::Rewind;
+                pendingAction_.frames = 60;
+            }
+            ImGui::Separator();
+            ImGui::TextUnformatted("Run-Ahead");
+            ImGui::RadioButton("Off", &runAheadFrames_, 0);
+            static const char* const frameLabels[MAX_RUN_AHEAD_FRAMES] = { "1", "2", "3", "4" };
+            for (int frames = 1; frames <= MAX_RUN_AHEAD_FRAMES; frames++) {
+                ImGui::SameLine();
+                ImGui::RadioButton(frameLabels[frames - 1], &runAheadFrames_, frames);
+            }
+            ImGui::Separator();
+            ImGui::MenuItem("Turbo", "Tab (hold)", &turboEnabled_);
+            static const int turboSpeeds[] = { 2, 3, 4, 8, 0 };
+            static const char* const turboLabels[] = { "2x", "3x", "4x", "8x", "Max" };
+            for (size_t i = 0; i < std::size(turboSpeeds); i++) {
+                if (i > 0) ImGui::SameLine();
+                ImGui::RadioButton(turboLabels[i], &turboSpeed_, turboSpeeds[i]);
+            }
             ImGui::EndMenu();
         }
 
@@ -218,6 +272,7 @@ void Gui::renderMenuBar() {
             ImGui::MenuItem("CPU Debugger", nullptr, &showCpuDebugger_);
             ImGui::MenuItem("PPU Viewer", nullptr, &showPpuViewer_);
             ImGui::MenuItem("APU Viewer", nullptr, &showApuViewer_);
+            ImGui::MenuItem("Performance", nullptr, &showPerformance_);
             ImGui::Separator();
             ImGui::MenuItem("Memory Viewer", nullptr, &showMemoryViewer_);
             ImGui::MenuItem("Palette Viewer", nullptr, &showPaletteViewer_);
@@ -235,6 +290,8 @@ void Gui::renderMenuBar() {
 
         if (ImGui::BeginMenu("View")) {
             ImGui::MenuItem("Emulator in Window", nullptr, &showEmulatorWindow_);
+            ImGui::Separator();
+            ImGui::SliderInt("Scaler Threads", &scalerThreads_, 1, MAX_SCALER_THREADS);
             ImGui::EndMenu();
         }
 
@@ -259,13 +316,13 @@ void Gui::renderCpuDebugger() {
         ImGui::Separator();
 
         ImGui::Columns(2, "regs", false);
-        ImGui::Text("PC: $%04X", bus_.cpu.getPC());
-        ImGui::Text("SP: $%02X", bus_.cpu.getSP());
-        ImGui::Text("A:  $%02X (%d)", bus_.cpu.getA(), bus_.cpu.getA());
+        ImGui::Text("PC: $%04X", snapshot_->pc);
+        ImGui::Text("SP: $%02X", snapshot_->sp);
+        ImGui::Text("A:  $%02X (%d)", snapshot_->a, snapshot_->a);
         ImGui::NextColumn();
-        ImGui::Text("X:  $%02X (%d)", bus_.cpu.getX(), bus_.cpu.getX());
-        ImGui::Text("Y:  $%02X (%d)", bus_.cpu.getY(), bus_.cpu.getY());
-        ImGui::Text("Cycles: %llu", bus_.cpu.getCycles());
+        ImGui::Text("X:  $%02X (%d)", snapshot_->x, snapshot_->x);
+        ImGui::Text("Y:  $%02X (%d)", snapshot_->y, snapshot_->y);
+        ImGui::Text("Cycles: %llu", snapshot_->cycles);
         ImGui::Columns(1);
 
         ImGui::Spacing();
@@ -273,7 +330,7 @@ void Gui::renderCpuDebugger() {
         // Flags
         ImGui::Text("Flags: ");
         ImGui::SameLine();
-        u8 status = bus_.cpu.getStatus();
+        u8 status = snapshot_->status;
         auto flagColor = [](bool set) {
             return set ? ImVec4(0.0f, 1.0f, 0.0f, 1.0f) : ImVec4(0.5f, 0.5f, 0.5f, 1.0f);
         };
@@ -293,7 +350,7 @@ void Gui::renderCpuDebugger() {
         ImGui::Text("Disassembly:");
         ImGui::BeginChild("Disasm", ImVec2(0, 200), ImGuiChildFlags_Borders);
 
-        u16 addr = bus_.cpu.getPC();
+        u16 addr = snapshot_->pc;
         for (int i = 0; i < 15; i++) {
             int len;
             std::string instr = disassembleInstruction(addr, len);
@@ -311,10 +368,10 @@ void Gui::renderCpuDebugger() {
         ImGui::Spacing();
         ImGui::Text("Stack (top 8 bytes):");
         ImGui::BeginChild("Stack", ImVec2(0, 60), ImGuiChildFlags_Borders);
-        u8 sp = bus_.cpu.getSP();
+        u8 sp = snapshot_->sp;
         for (int i = 0; i < 8 && (sp + i + 1) <= 0xFF; i++) {
             u16 stackAddr = 0x0100 + sp + i + 1;
-            ImGui::Text("$%04X: $%02X", stackAddr, bus_.read(stackAddr));
+            ImGui::Text("$%04X: $%02X", stackAddr, snapshot_->stack[stackAddr & 0xFF]);
             ImGui::SameLine();
         }
         ImGui::EndChild();
@@ -330,23 +387,23 @@ void Gui::renderPpuViewer() {
             ImGui::Separator();
 
             ImGui::Columns(2, "ppuregs", false);
-            ImGui::Text("Scanline: %d", bus_.ppu.getScanline());
-            ImGui::Text("Cycle: %d", bus_.ppu.getCycle());
-            ImGui::Text("VRAM Addr: $%04X", bus_.ppu.getVramAddr());
-            ImGui::Text("Temp Addr: $%04X", bus_.ppu.getTempAddr());
+            ImGui::Text("Scanline: %d", snapshot_->scanline);
+            ImGui::Text("Cycle: %d", snapshot_->ppu_cycle);
+            ImGui::Text("VRAM Addr: $%04X", snapshot_->vram_addr);
+            ImGui::Text("Temp Addr: $%04X", snapshot_->temp_addr);
 
             ImGui::NextColumn();
-            ImGui::Text("Fine X: %d", bus_.ppu.getFineX());
-            ImGui::Text("Write Toggle: %s", bus_.ppu.getWriteToggle() ? "1" : "0");
-            ImGui::Text("Frame Complete: %s", bus_.ppu.isFrameComplete() ? "Yes" : "No");
-            ImGui::Text("NMI Occurred: %s", bus_.ppu.isNMI() ? "Yes" : "No");
+            ImGui::Text("Fine X: %d", snapshot_->fine_x);
+            ImGui::Text("Write Toggle: %s", snapshot_->write_toggle ? "1" : "0");
+            ImGui::Text("Frame Complete: %s", snapshot_->frame_complete ? "Yes" : "No");
+            ImGui::Text("NMI Occurred: %s", snapshot_->nmi ? "Yes" : "No");
             ImGui::Columns(1);
 
             ImGui::Spacing();
             ImGui::Separator();
 
             // PPUCTRL ($2000)
-            u8 ctrl = bus_.ppu.getCtrl();
+            u8 ctrl = snapshot_->ctrl;
             ImGui::Text("PPUCTRL ($2000): $%02X", ctrl);
             ImGui::Text("  Base NT: $%04X", 0x2000 + (ctrl & 0x03) * 0x400);
             ImGui::Text("  VRAM Inc: %s", (ctrl & 0x04) ? "+32" : "+1");
@@ -358,7 +415,7 @@ void Gui::renderPpuViewer() {
             ImGui::Spacing();
 
             // PPUMASK ($2001)
-            u8 mask = bus_.ppu.getMask();
+            u8 mask = snapshot_->mask;
             ImGui::Text("PPUMASK ($2001): $%02X", mask);
             ImGui::Text("  Grayscale: %s", (mask & 0x01) ? "Yes" : "No");
             ImGui::Text("  Show BG Left 8: %s", (mask & 0x02) ? "Yes" : "No");
@@ -369,7 +426,7 @@ void Gui::renderPpuViewer() {
             ImGui::Spacing();
 
             // PPUSTATUS ($2002)
-            u8 status = bus_.ppu.getStatus();
+            u8 status = snapshot_->ppu_status;
             ImGui::Text("PPUSTATUS ($2002): $%02X", status);
             ImGui::Text("  Sprite Overflow: %s", (status & 0x20) ? "Yes" : "No");
             ImGui::Text("  Sprite 0 Hit: %s", (status & 0x40) ? "Yes" : "No");
@@ -393,7 +450,7 @@ void Gui::renderPaletteViewer() {
             for (int pal = 0; pal < 4; pal++) {
                 for (int col = 0; col < 4; col++) {
                     u16 addr = 0x3F00 + pal * 4 + col;
-                    u8 colorIdx = bus_.read(addr);
+                    u8 colorIdx = snapshot_->palette[addr & 0x1F];
                     ImU32 color = nesColorToImU32(colorIdx);
 
                     float x = pos.x + (pal * 4 + col) * (boxSize + spacing);
@@ -417,7 +474,7 @@ void Gui::renderPaletteViewer() {
             for (int pal = 0; pal < 4; pal++) {
                 for (int col = 0; col < 4; col++) {
                     u16 addr = 0x3F10 + pal * 4 + col;
-                    u8 colorIdx = bus_.read(addr);
+                    u8 colorIdx = snapshot_->palette[addr & 0x1F];
                     ImU32 color = nesColorToImU32(colorIdx);
 
                     float x = pos.x + (pal * 4 + col) * (boxSize + spacing);
@@ -469,53 +526,38 @@ void Gui::renderPatternTableViewer() {
         
             ImGui::SliderInt("Palette", &patternTablePalette_, 0, 7);
 
-            ImDrawList* drawList = ImGui::GetWindowDrawList();
-            float scale = 2.0f;
-            float tileSize = 8.0f * scale;
-
-            // Two pattern tables: $0000-$0FFF and $1000-$1FFF
-            for (int table = 0; table < 2; table++) {
-                ImGui::Text("Pattern Table %d ($%04X):", table, table * 0x1000);
-                ImVec2 pos = ImGui::GetCursorScreenPos();
+            const ViewerKey key = makeViewerKey(patternTablePalette_);
+            if (key != patternKey_) {
+                patternKey_ = key;
+
+                // Palettes 0-3 are background, 4-7 sprite; colour 0 is always
+                // the backdrop ($3F10/14/18/1C mirror $3F00)
+                const u8* palette = snapshot_->palette.data();
+                const int base = (patternTablePalette_ & 7) * 4;
+                u32 colors[4];
+                colors[0] = nesColorToImU32(palette[0]);
+                for (int i = 1; i < 4; i++) {
+                    colors[i] = nesColorToImU32(palette[base + i]);
+                }
 
-                for (int tileY = 0; tileY < 16; tileY++) {
-                    for (int tileX = 0; tileX < 16; tileX++) {
-                        int tileIdx = tileY * 16 + tileX;
+                // Two pattern tables, $0000-$0FFF and $1000-$1FFF, side by side
+                for (int table = 0; table < 2; table++) {
+                    for (int tileIdx = 0; tileIdx < 256; tileIdx++) {
+                        int x = table * 128 + (tileIdx % 16) * 8;
+                        int y = (tileIdx / 16) * 8;
                         u16 tileAddr = table * 0x1000 + tileIdx * 16;
-
-                        for (int row = 0; row < 8; row++) {
-                            u8 lo = bus_.cartridge.readChr(tileAddr + row);
-                            u8 hi = bus_.cartridge.readChr(tileAddr + row + 8);
-
-                            for (int col = 0; col < 8; col++) {
-                                u8 bit = 7 - col;
-                                u8 pixel = ((lo >> bit) & 1) | (((hi >> bit) & 1) << 1);
-
-                                // Get color from selected palette
-                                u16 palAddr = 0x3F00 + (patternTablePalette_ % 4) * 4;
-                                if (patternTablePalette_ >= 4) palAddr = 0x3F10 + (patternTablePalette_ % 4) * 4;
-                                u8 colorIdx = bus_.read(palAddr + pixel);
-                                ImU32 color = nesColorToImU32(colorIdx);
-
-                                float x = pos.x + (tileX * 8 + col) * scale + table * (128 * scale + 20);
-                                float y = pos.y + (tileY * 8 + row) * scale;
-
-                                drawList->AddRectFilled(
-                                    ImVec2(x, y),
-                                    ImVec2(x + scale, y + scale),
-                                    color
-                                );
-                            }
-                        }
+                        decodeTile(&patternPixels_[y * 256 + x], 256, tileAddr, colors);
                     }
                 }
-
-                if (table == 0) {
-                    ImGui::SameLine();
-                    ImGui::Dummy(ImVec2(128 * scale + 20, 0));
-                }
+                patternTexture_.update(reinterpret_cast<const u8*>(patternPixels_.data()));
             }
-            ImGui::Dummy(ImVec2(0, 128 * scale + 10));
+
+            float scale = 2.0f;
+            float left = ImGui::GetCursorPosX();
+            ImGui::Text("Pattern Table 0 ($0000):");
+            ImGui::SameLine(left + 128 * scale);
+            ImGui::Text("Pattern Table 1 ($1000):");
+            ImGui::Image(patternTexture_, sf::Vector2f(256 * scale, 128 * scale));
 
     }
     ImGui::End();
@@ -525,59 +567,47 @@ void Gui::renderNametableViewer() {
     ImGui::SetNextWindowSize(ImVec2(600, 550), ImGuiCond_FirstUseEver);
     if (ImGui::Begin("Nametables", &showNametableViewer_)) {
         
-            ImDrawList* drawList = ImGui::GetWindowDrawList();
-            float scale = 1.0f;
-            ImVec2 pos = ImGui::GetCursorScreenPos();
+            // Background tiles come from the pattern table PPUCTRL selects
+            const u16 ptBase = (snapshot_->ctrl & 0x10) ? 0x1000 : 0x0000;
+
+            const ViewerKey key = makeViewerKey(ptBase);
+            if (key != nametableKey_) {
+                nametableKey_ = key;
+
+                // The four background palettes, colour 0 being the backdrop
+                const u8* palette = snapshot_->palette.data();
+                u32 colors[4][4];
+                for (int pal = 0; pal < 4; pal++) {
+                    colors[pal][0] = nesColorToImU32(palette[0]);
+                    for (int i = 1; i < 4; i++) {
+                        colors[pal][i] = nesColorToImU32(palette[pal * 4 + i]);
+                    }
+                }
 
-            // Draw 4 nametables in 2x2 grid
-            for (int ntY = 0; ntY < 2; ntY++) {
-                for (int ntX = 0; ntX < 2; ntX++) {
-                    u16 ntBase = 0x2000 + (ntY * 2 + ntX) * 0x400;
+                // 4 nametables in a 2x2 grid, as mirrored on the cartridge
+                for (int nt = 0; nt < 4; nt++) {
+                    const u8* page = snapshot_->nametables[nt].data();
+                    const int ntX = nt & 1;
+                    const int ntY = nt >> 1;
 
                     for (int tileY = 0; tileY < 30; tileY++) {
                         for (int tileX = 0; tileX < 32; tileX++) {
-                            u16 ntAddr = ntBase + tileY * 32 + tileX;
-                            u8 tileIdx = bus_.read(ntAddr);
+                            u8 tileIdx = page[tileY * 32 + tileX];
 
-                            // Get attribute
-                            u16 atAddr = ntBase + 0x3C0 + (tileY / 4) * 8 + (tileX / 4);
-                            u8 attr = bus_.read(atAddr);
+                            u8 attr = page[0x3C0 + (tileY / 4) * 8 + (tileX / 4)];
                             int shift = ((tileY & 2) ? 4 : 0) + ((tileX & 2) ? 2 : 0);
                             u8 palIdx = (attr >> shift) & 0x03;
 
-                            // Get BG pattern table from PPUCTRL
-                            u16 ptBase = (bus_.ppu.getCtrl() & 0x10) ? 0x1000 : 0x0000;
-                            u16 tileAddr = ptBase + tileIdx * 16;
-
-                            // Draw tile (simplified - just color blocks)
-                            for (int row = 0; row < 8; row++) {
-                                u8 lo = bus_.cartridge.readChr(tileAddr + row);
-                                u8 hi = bus_.cartridge.readChr(tileAddr + row + 8);
-
-                                for (int col = 0; col < 8; col++) {
-                                    u8 bit = 7 - col;
-                                    u8 pixel = ((lo >> bit) & 1) | (((hi >> bit) & 1) << 1);
-
-                                    u16 palAddr = 0x3F00 + palIdx * 4 + pixel;
-                                    u8 colorIdx = bus_.read(palAddr);
-                                    ImU32 color = nesColorToImU32(colorIdx);
-
-                                    float x = pos.x + (ntX * 256 + tileX * 8 + col) * scale;
-                                    float y = pos.y + (ntY * 240 + tileY * 8 + row) * scale;
-
-                                    drawList->AddRectFilled(
-                                        ImVec2(x, y),
-                                        ImVec2(x + scale, y + scale),
-                                        color
-                                    );
-                                }
-                            }
+                            int x = ntX * 256 + tileX * 8;
+                            int y = ntY * 240 + tileY * 8;
+                            decodeTile(&nametablePixels_[y * 512 + x], 512, ptBase + tileIdx * 16, colors[palIdx]);
                         }
                     }
                 }
+                nametableTexture_.update(reinterpret_cast<const u8*>(nametablePixels_.data()));
             }
 
-            ImGui::Dummy(ImVec2(512 * scale, 480 * scale));
+            ImGui::Image(nametableTexture_, sf::Vector2f(512, 480));
 
     }
     ImGui::End();
@@ -599,7 +629,7 @@ void Gui::renderOamViewer() {
                 ImGui::TableSetupColumn("Flags", ImGuiTableColumnFlags_WidthStretch);
                 ImGui::TableHeadersRow();
 
-                const u8* oam = bus_.ppu.getOam();
+                const u8* oam = snapshot_->oam.data();
                 for (int i = 0; i < 64; i++) {
                     u8 y = oam[i * 4 + 0];
                     u8 tile = oam[i * 4 + 1];
@@ -642,10 +672,10 @@ void Gui::renderOamViewer() {
             }
 
             // Sprite size info
-            bool is8x16 = (bus_.ppu.getCtrl() & 0x20) != 0;
+            bool is8x16 = (snapshot_->ctrl & 0x20) != 0;
             ImGui::Text("Sprite Size: %s", is8x16 ? "8x16" : "8x8");
             if (!is8x16) {
-                ImGui::Text("Sprite Pattern Table: $%04X", (bus_.ppu.getCtrl() & 0x08) ? 0x1000 : 0x0000);
+                ImGui::Text("Sprite Pattern Table: $%04X", (snapshot_->ctrl & 0x08) ? 0x1000 : 0x0000);
             }
 
     }
@@ -687,21 +717,23 @@ void Gui::renderMemoryViewer() {
             int maxAddr = (memoryViewType_ == 0) ? 0xFFFF : 0x3FFF;
             int displayLines = 16;
 
+            // The 256 visible bytes span at most two pages, captured with the
+            // snapshot; right after a move to other pages they arrive with
+            // the next one
+            const u8* pages = snapshot_->memory.data();
+            if (snapshot_->memory_view != getMemoryView()) {
+                displayLines = 0;
+            }
+
             for (int line = 0; line < displayLines; line++) {
                 int lineAddr = (memoryViewAddress_ + line * 16) & maxAddr;
+                const u8* lineBytes = pages + (memoryViewAddress_ & 0xFF) + line * 16;
                 ImGui::Text("%04X: ", lineAddr);
                 ImGui::SameLine();
 
                 // Hex display
                 for (int i = 0; i < 16; i++) {
-                    int addr = (lineAddr + i) & maxAddr;
-                    u8 val;
-                    if (memoryViewType_ == 0) {
-                        val = bus_.read(addr);
-                    } else {
-                        val = bus_.cartridge.readChr(addr);
-                    }
-                    ImGui::Text("%02X", val);
+                    ImGui::Text("%02X", lineBytes[i]);
                     ImGui::SameLine();
                     if (i == 7) {
                         ImGui::Text(" ");
@@ -713,13 +745,7 @@ void Gui::renderMemoryViewer() {
                 ImGui::Text(" |");
                 ImGui::SameLine();
                 for (int i = 0; i < 16; i++) {
-                    int addr = (lineAddr + i) & maxAddr;
-                    u8 val;
-                    if (memoryViewType_ == 0) {
-                        val = bus_.read(addr);
-                    } else {
-                        val = bus_.cartridge.readChr(addr);
-                    }
+                    u8 val = lineBytes[i];
                     char c = (val >= 32 && val < 127) ? static_cast<char>(val) : '.';
                     ImGui::Text("%c", c);
                     ImGui::SameLine();
@@ -750,44 +776,44 @@ void Gui::renderApuViewer() {
             ImGui::Separator();
 
             // Pulse 1
-            auto p1 = bus_.apu.getPulse1Status();
+            auto p1 = snapshot_->pulse1;
             ImGui::Text("Pulse 1:");
             ImGui::ProgressBar(p1.enabled ? (p1.volume / 15.0f) : 0.0f, ImVec2(100, 14));
             ImGui::SameLine();
             ImGui::Text("Vol:%d Per:%d Len:%d %s", p1.volume, p1.period, p1.length, p1.enabled ? "ON" : "OFF");
 
             // Pulse 2
-            auto p2 = bus_.apu.getPulse2Status();
+            auto p2 = snapshot_->pulse2;
             ImGui::Text("Pulse 2:");
             ImGui::ProgressBar(p2.enabled ? (p2.volume / 15.0f) : 0.0f, ImVec2(100, 14));
             ImGui::SameLine();
             ImGui::Text("Vol:%d Per:%d Len:%d %s", p2.volume, p2.period, p2.length, p2.enabled ? "ON" : "OFF");
 
             // Triangle
-            auto tri = bus_.apu.getTriangleStatus();
+            auto tri = snapshot_->triangle;
             ImGui::Text("Triangle:");
             ImGui::ProgressBar(tri.enabled ? 0.5f : 0.0f, ImVec2(100, 14));
             ImGui::SameLine();
             ImGui::Text("Per:%d Len:%d %s", tri.period, tri.length, tri.enabled ? "ON" : "OFF");
 
             // Noise
-            auto noise = bus_.apu.getNoiseStatus();
+            auto noise = snapshot_->noise;
             ImGui::Text("Noise:");
             ImGui::ProgressBar(noise.enabled ? (noise.volume / 15.0f) : 0.0f, ImVec2(100, 14));
             ImGui::SameLine();
             ImGui::Text("Vol:%d Per:%d Len:%d %s", noise.volume, noise.period, noise.length, noise.enabled ? "ON" : "OFF");
 
             // DMC
-            auto dmc = bus_.apu.getDMCStatus();
+            auto dmc = snapshot_->dmc;
             ImGui::Text("DMC:");
             ImGui::ProgressBar(dmc.enabled ? (dmc.volume / 127.0f) : 0.0f, ImVec2(100, 14));
             ImGui::SameLine();
             ImGui::Text("Out:%d Rate:%d %s", dmc.volume, dmc.period, dmc.enabled ? "ON" : "OFF");
 
             ImGui::Separator();
-            ImGui::Text("Frame Counter Mode: %d", bus_.apu.getFrameCounterMode());
-            ImGui::Text("IRQ Inhibit: %s", bus_.apu.getIrqInhibit() ? "Yes" : "No");
-            ImGui::Text("IRQ Pending: %s", bus_.apu.isIRQ() ? "Yes" : "No");
+            ImGui::Text("Frame Counter Mode: %d", snapshot_->frame_counter_mode);
+            ImGui::Text("IRQ Inhibit: %s", snapshot_->irq_inhibit ? "Yes" : "No");
+            ImGui::Text("IRQ Pending: %s", snapshot_->apu_irq ? "Yes" : "No");
 
     }
     ImGui::End();
@@ -844,23 +870,23 @@ void Gui::renderGameGenie() {
 void Gui::renderCartridgeInfo() {
     ImGui::SetNextWindowSize(ImVec2(300, 250), ImGuiCond_FirstUseEver);
     if (ImGui::Begin("Cartridge Info", &showCartridgeInfo_)) {
-        if (bus_.cartridge.isLoaded()) {
+        if (snapshot_->cartridge_loaded) {
             ImGui::Text("Cartridge Information:");
             ImGui::Separator();
 
             ImGui::Text("Mapper: %d (%s)", 
-                bus_.cartridge.getMapperNumber(),
-                bus_.cartridge.getMapperName());
+                snapshot_->mapper_number,
+                snapshot_->mapper_name.c_str());
 
             const char* mirrorNames[] = { "Horizontal", "Vertical", "Single (Lower)", "Single (Upper)", "Four-Screen" };
-            int mirrorIdx = static_cast<int>(bus_.cartridge.getMirroring());
+            int mirrorIdx = static_cast<int>(snapshot_->mirroring);
             if (mirrorIdx >= 0 && mirrorIdx < 5) {
                 ImGui::Text("Mirroring: %s", mirrorNames[mirrorIdx]);
             }
 
-            ImGui::Text("Battery: %s", bus_.cartridge.hasBattery() ? "Yes" : "No");
-            ImGui::Text("PRG ROM: %zu KB", bus_.cartridge.getPrgRom().size() / 1024);
-            ImGui::Text("CHR ROM: %zu KB", bus_.cartridge.getChrRom().size() / 1024);
+            ImGui::Text("Battery: %s", snapshot_->battery ? "Yes" : "No");
+            ImGui::Text("PRG ROM: %zu KB", snapshot_->prg_rom_size / 1024);
+            ImGui::Text("CHR ROM: %zu KB", snapshot_->chr_rom_size / 1024);
         } else {
             ImGui::Text("No cartridge loaded");
         }
@@ -996,6 +1022,109 @@ void Gui::renderConsole() {
     console_.render(&showConsole_);
 }
 
+void Gui::renderPerformance() {
+    ImGui::SetNextWindowSize(ImVec2(420, 520), ImGuiCond_FirstUseEver);
+    if (ImGui::Begin("Performance", &showPerformance_)) {
+#ifdef VNES_PROFILER
+        Profiler& profiler = Profiler::instance();
+        const Profiler::FrameStats avg = profiler.getAverage();
+        const float fps = avg.frame_ms > 0.0f ? 1000.0f / avg.frame_ms : 0.0f;
+
+        ImGui::Text("FPS: %.1f  (%.2f ms/frame, %zu frame avg)", fps, avg.frame_ms, profiler.getFrameCount());
+        ImGui::Separator();
+
+        // Frame time, scaled so the 60 Hz budget sits at mid-height
+        profiler.getFrameTimeHistory(perfHistory_);
+        if (!perfHistory_.empty()) {
+            const std::string overlay = std::format("frame {:.2f} ms", perfHistory_.back());
+            ImGui::PlotLines("##frame", perfHistory_.data(), static_cast<int>(perfHistory_.size()), 0,
+                             overlay.c_str(), 0.0f, 33.3f, ImVec2(-1, 50));
+        }
+
+        for (size_t i = 0; i < Profiler::STAGE_COUNT; i++) {
+            const auto stage = static_cast<ProfileStage>(i);
+            profiler.getStageHistory(stage, perfHistory_);
+
+            float peak = 0.0f;
+            for (float ms : perfHistory_) {
+                peak = std::max(peak, ms);
+            }
+
+            ImGui::Text("%-16s avg %6.3f ms  peak %6.3f ms", Profiler::getStageName(stage), avg.stage_ms[i], peak);
+            if (!perfHistory_.empty()) {
+                const std::string id = std::format("##stage{}", i);
+                ImGui::PlotHistogram(id.c_str(), perfHistory_.data(), static_cast<int>(perfHistory_.size()), 0,
+                                     nullptr, 0.0f, std::max(peak, 1.0f), ImVec2(-1, 40));
+            }
+        }
+
+        ImGui::Separator();
+        ImGui::Text("Chrome trace capture:");
+        if (!profiler.isTracing()) {
+            if (ImGui::Button("Start Capture")) {
+                profiler.startTrace();
+                traceStatus_.clear();
+            }
+        }
+        else {
+            ImGui::SameLine();
+            ImGui::Text("%zu events", profiler.getTraceEventCount());
+            if (ImGui::Button("Stop && Save")) {
+                profiler.stopTrace();
+                const std::string path = "vnes_trace.json";
+                traceStatus_ = profiler.writeChromeTrace(path)
+                    ? "Saved " + path + " (open in chrome://tracing or ui.perfetto.dev)"
+                    : "Failed to write " + path;
+            }
+        }
+        if (!traceStatus_.empty()) {
+            ImGui::TextWrapped("%s", traceStatus_.c_str());
+        }
+#else
+        ImGui::TextDisabled("Profiler disabled at build time (build with VNES_PROFILER).");
+#endif
+
+        // Emulation thread pacing: how late each frame started past its deadline
+        const PacingStats& pacing = pacingStats_;
+        ImGui::Separator();
+        ImGui::Text("Frame pacing: %.4f Hz target, %.4f Hz measured", pacing.target_rate, pacing.measured_rate);
+        ImGui::Text("Lateness: mean %.0f us  stddev %.0f us  max %.0f us", pacing.mean_us, pacing.stddev_us, pacing.max_us);
+        ImGui::Text("Spin margin %.0f us, %u resyncs", pacing.spin_margin_us, pacing.resyncs);
+        ImGui::Text("Emulating %.1f frames/s (x%.2f)", pacing.emulation_rate, pacing.emulation_rate / NTSC_FRAME_RATE);
+        if (pacing.count > 0) {
+            ImGui::PlotLines("##lateness", pacing.lateness_us.data(), static_cast<int>(pacing.count),
+                             static_cast<int>(pacing.head), "lateness (us)", 0.0f, std::max(pacing.max_us, 100.0f),
+                             ImVec2(-1, 50));
+        }
+        ImGui::Text("Audio buffer: %zu / %zu samples, rate x%.5f",
+                    pacing.audio_buffered, pacing.audio_target, pacing.audio_rate_scale);
+    }
+    ImGui::End();
+}
+
+void Gui::renderTurboOverlay() {
+    // Top-left corner, below the menu bar when it is shown
+    const float top = menuVisible_ ? ImGui::GetFrameHeight() + 10.0f : 10.0f;
+    ImGui::SetNextWindowPos(ImVec2(10.0f, top));
+    ImGui::SetNextWindowBgAlpha(0.5f);
+    const ImGuiWindowFlags flags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize |
+                                   ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing |
+                                   ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoInputs;
+    if (ImGui::Begin("##Turbo", nullptr, flags)) {
+        const double rate = pacingStats_.emulation_rate;
+        ImGui::Text(">> x%.1f  %.0f fps", rate / NTSC_FRAME_RATE, rate);
+    }
+    ImGui::End();
+}
+
+DebugSnapshot::MemoryView Gui::getMemoryView() const {
+    const int maxAddr = (memoryViewType_ == 0) ? 0xFFFF : 0x3FFF;
+    DebugSnapshot::MemoryView view;
+    view.page = static_cast<u8>((memoryViewAddress_ & maxAddr) >> 8);
+    view.ppu = memoryViewType_ != 0;
+    return view;
+}
+
 bool Gui::isMenuVisible() const {
     return menuVisible_;
 }
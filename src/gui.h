@@ -2,18 +2,17 @@
 #include <SFML/Graphics.hpp>
 #include <imgui.h>
 #include <ImGui-SFML.h>
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <functional>
 #include "types.h"
+#include "debug_snapshot.h"
+#include "frame_scheduler.h"
 #include "gui_console.h"
 
 // Forward declarations
 class Bus;
-class CPU;
-class PPU;
-class APU;
-class Cartridge;
 
 // GUI Actions that main loop should handle
 struct GuiAction {
@@ -25,10 +24,12 @@ struct GuiAction {
         Resume,
         Step,
         StepFrame,
+        Rewind,
         Quit
     };
     Type type = None;
     std::string romPath;  // For LoadRom
+    int frames = 0;       // For Rewind
 };
 
 class Gui {
@@ -38,12 +39,19 @@ public:
     void initialize(sf::RenderWindow& window);
     void processEvent(sf::RenderWindow& window, const sf::Event& event);
     void update(sf::RenderWindow& window, float dt);
+
+    // Build this frame's windows from the debug snapshot (no Bus access),
+    // then draw them with render()
+    void build();
     void render(sf::RenderWindow& window);
     bool isMenuVisible() const;
     void toggleMenu();
 
-    // Update emulator screen texture (called each frame)
-    void updateEmulatorTexture(const u32* framebuffer, unsigned width, unsigned height);
+    // True while there is something to draw: the menu, or the turbo overlay
+    bool isVisible() const { return menuVisible_ || turboActive_; }
+
+    // Update emulator screen texture from RGBA pixels (called each frame)
+    void updateEmulatorTexture(const u8* pixels, unsigned width, unsigned height);
 
     // Returns true if a new Game Genie code was entered
     bool getGameGenieCode(std::string& code);
@@ -64,6 +72,37 @@ public:
     // Get console for breakpoint checking
     GuiConsole& getConsole() { return console_; }
 
+    // Threads the HQ2x scaler splits each frame across (View menu)
+    static const int MAX_SCALER_THREADS = 8;
+    int getScalerThreads() const { return scalerThreads_; }
+    void setScalerThreads(int threads) { scalerThreads_ = std::clamp(threads, 1, MAX_SCALER_THREADS); }
+
+    // Frames emulated ahead of the shown one to hide input lag, 0 = off
+    // (Emulation menu)
+    static const int MAX_RUN_AHEAD_FRAMES = 4;
+    int getRunAheadFrames() const { return runAheadFrames_; }
+    void setRunAheadFrames(int frames) { runAheadFrames_ = std::clamp(frames, 0, MAX_RUN_AHEAD_FRAMES); }
+
+    // Turbo (Emulation menu, or hold Tab): frames emulated per NTSC frame
+    // period, 0 = as fast as possible
+    static const int MAX_TURBO_SPEED = 16;
+    bool isTurboEnabled() const { return turboEnabled_; }
+    int getTurboSpeed() const { return turboSpeed_; }
+    void setTurboSpeed(int speed) { turboSpeed_ = speed == 0 ? 0 : std::clamp(speed, 2, MAX_TURBO_SPEED); }
+
+    // Whether turbo is in effect this frame; shows the achieved rate on screen
+    void setTurboActive(bool active) { turboActive_ = active; }
+
+    // Frame pacing and audio buffer statistics for Debug -> Performance
+    void setPacingStats(const PacingStats& stats) { pacingStats_ = stats; }
+
+    // Machine state for the debug windows; must stay valid until the next
+    // call (EmuThread::takeDebugSnapshot)
+    void setDebugSnapshot(const DebugSnapshot& snapshot) { snapshot_ = &snapshot; }
+
+    // Pages the memory viewer shows, to be captured in the snapshot
+    DebugSnapshot::MemoryView getMemoryView() const;
+
 private:
     void renderMenuBar();
     void renderCpuDebugger();
@@ -79,10 +118,27 @@ private:
     void renderEmulatorWindow();
     void renderFileDialog();
     void renderConsole();
+    void renderPerformance();
+    void renderTurboOverlay();
 
     // Helper to convert NES color index to ImGui color
     ImU32 nesColorToImU32(u8 colorIndex) const;
 
+    // The pattern table and nametable viewers decode into RGBA buffers that
+    // are uploaded to a texture only when the inputs below changed
+    struct ViewerKey {
+        u32 chr = 0;
+        u32 nametables = 0;
+        u32 palette = 0;
+        int option = -1;    // selected palette, or the PPUCTRL background table
+        bool operator==(const ViewerKey&) const = default;
+    };
+    ViewerKey makeViewerKey(int option) const;
+
+    // Decode the 8x8 tile at `tileAddr` into `out` (`stride` pixels per row)
+    // with four RGBA colours, from the snapshot's copy of the CHR banks
+    void decodeTile(u32* out, int stride, u16 tileAddr, const u32* colors) const;
+
     // Disassemble instructions
     std::string disassembleInstruction(u16 addr, int& length);
 
@@ -103,6 +159,7 @@ private:
     bool showEmulatorWindow_;
     bool showFileDialog_;
     bool showConsole_;
+    bool showPerformance_;
 
     // Game Genie state
     char ggInput_[32];
@@ -117,8 +174,25 @@ private:
     // Pattern table viewer state
     int patternTablePalette_;
 
-    // Emulator components
-    Bus& bus_;
+    // Cached viewer images (see ViewerKey)
+    sf::Texture patternTexture_;
+    std::vector<u32> patternPixels_;
+    ViewerKey patternKey_;
+    sf::Texture nametableTexture_;
+    std::vector<u32> nametablePixels_;
+    ViewerKey nametableKey_;
+
+    // Video settings
+    int scalerThreads_;
+
+    // Emulation settings
+    int runAheadFrames_;
+    bool turboEnabled_;
+    int turboSpeed_;
+    bool turboActive_;
+
+    // Emulator state, as of the newest snapshot
+    const DebugSnapshot* snapshot_;
 
     // Emulator screen texture for windowed mode
     sf::Texture emulatorTexture_;
@@ -135,4 +209,9 @@ private:
 
     // Debugger console
     GuiConsole console_;
+
+    // Performance window state
+    std::vector<float> perfHistory_;
+    PacingStats pacingStats_;
+    std::string traceStatus_;
 };
@@ -122,7 +122,7 @@ void GuiConsole::render(bool* open) {
         std::string cmd(inputBuf_);
         if (!cmd.empty()) {
             printColored("> " + cmd, colorGreen);
-            executeCommand(cmd);
+            pendingCommands_.push_back(cmd);
             
             // Add to history (avoid duplicates)
             if (history_.empty() || history_.back() != cmd) {
@@ -220,6 +220,14 @@ void GuiConsole::printRegisters() {
     }
 }
 
+bool GuiConsole::pollCommand(std::string& cmdLine) {
+    if (pendingCommands_.empty()) return false;
+
+    cmdLine = std::move(pendingCommands_.front());
+    pendingCommands_.pop_front();
+    return true;
+}
+
 void GuiConsole::executeCommand(const std::string& cmdLine) {
     auto tokens = tokenize(cmdLine);
     if (tokens.empty()) {
@@ -422,17 +430,17 @@ void GuiConsole::cmdStep(int count) {
         printHighlight(instr);
         
         // Show memory accesses
-        const auto& log = bus_.getAccessLog();
         std::ostringstream accesses;
         bool hasAccesses = false;
-        for (const auto& access : log) {
+        for (size_t n = 0; n < bus_.getAccessCount(); n++) {
+            const MemAccess& access = bus_.getAccess(n);
             if (access.type == MemAccess::READ && access.addr >= 0x8000 &&
                 access.addr >= prevPc_ && access.addr < prevPc_ + len) {
                 continue;
             }
             if (hasAccesses) accesses << ", ";
             accesses << (access.type == MemAccess::READ ? "R " : "W ");
-            accesses << access.region << "=$" << hexByte(access.value);
+            accesses << Bus::getRegionName(access.addr) << "=$" << hexByte(access.value);
             hasAccesses = true;
         }
         if (hasAccesses) {
@@ -474,12 +482,12 @@ void GuiConsole::cmdMemory(u16 addr, int count) {
         line << hexWord(addr + i) << ": ";
         
         for (int j = 0; j < 16 && (i + j) < count; j++) {
-            line << hexByte(bus_.read(addr + i + j)) << " ";
+            line << hexByte(bus_.peek(addr + i + j)) << " ";
         }
         
         line << " |";
         for (int j = 0; j < 16 && (i + j) < count; j++) {
-            u8 c = bus_.read(addr + i + j);
+            u8 c = bus_.peek(addr + i + j);
             line << static_cast<char>((c >= 32 && c < 127) ? c : '.');
         }
         line << "|";
@@ -537,7 +545,7 @@ void GuiConsole::cmdStack() {
     printInfo("Stack (SP=$" + hexByte(sp) + "):");
     
     for (int i = 0xFF; i > sp; i--) {
-        u8 val = bus_.read(0x0100 + i);
+        u8 val = bus_.peek(0x0100 + i);
         print("  $01" + hexByte(i) + ": " + hexByte(val));
     }
 }
@@ -772,7 +780,7 @@ void GuiConsole::cmdClear() {
 std::string GuiConsole::disassembleInstruction(u16 addr, int& length) {
     
     
-    u8 opcode = bus_.read(addr);
+    u8 opcode = bus_.peek(addr);
     const char* name = opcodeNames[opcode];
     AddrMode mode = addrModes[opcode];
     
@@ -794,7 +802,7 @@ std::string GuiConsole::disassembleInstruction(u16 addr, int& length) {
         case IZX:
         case IZY:
         case REL:
-            lo = bus_.read(addr + 1);
+            lo = bus_.peek(addr + 1);
             line << hexByte(lo) << "    ";
             length = 2;
             break;
@@ -802,8 +810,8 @@ std::string GuiConsole::disassembleInstruction(u16 addr, int& length) {
         case ABX:
         case ABY:
         case IND:
-            lo = bus_.read(addr + 1);
-            hi = bus_.read(addr + 2);
+            lo = bus_.peek(addr + 1);
+            hi = bus_.peek(addr + 2);
             line << hexByte(lo) << " " << hexByte(hi) << " ";
             length = 3;
             break;
@@ -38,9 +38,14 @@ public:
     const std::set<u16>& getBreakpoints() const { return breakpoints_; }
     bool hasBreakpoint(u16 addr) const { return breakpoints_.count(addr) > 0; }
 
+    // Commands read and change the Bus, so render() only queues them; the
+    // main loop takes each with pollCommand and runs it under the bus lock
+    // (EmuThread::runCommand)
+    bool pollCommand(std::string& cmdLine);
+    void executeCommand(const std::string& cmdLine);
+
 private:
     // Command processing
-    void executeCommand(const std::string& cmdLine);
     std::vector<std::string_view> tokenize(const std::string& line);
     
     // Commands
@@ -97,6 +102,9 @@ private:
     // Command history
     std::vector<std::string> history_;
     int historyPos_;
+
+    // Entered but not run yet (see pollCommand)
+    std::deque<std::string> pendingCommands_;
     
     // Breakpoints
     std::set<u16> breakpoints_;
@@ -0,0 +1,161 @@
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include "bus.h"
+#include "wav_writer.h"
+#include "util.h"
+
+// Headless runner: links only the emulation core (Bus/CPU/PPU/APU/Cartridge/mappers).
+// Runs a ROM for N frames as fast as the host allows and reports framebuffer
+// hashes and throughput, optionally capturing audio to a .wav file.
+
+using vnes::util::toHex;
+
+static void printUsage(const char* program)
+{
+    std::cout << "VNES - Headless NES Emulator" << std::endl;
+    std::cout << "Usage: " << program << " [options] rom.nes" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  -n, --frames N     Number of frames to run (default 600)" << std::endl;
+    std::cout << "  -H, --hashes FILE  Write one framebuffer hash per frame to FILE" << std::endl;
+    std::cout << "  -w, --wav FILE     Capture audio output to FILE (16-bit mono PCM)" << std::endl;
+    std::cout << "  -r, --rate HZ      Audio sample rate, e.g. 48000 (default 44100)" << std::endl;
+    std::cout << "  -a, --run-ahead N  Hash the frame N frames ahead (run-ahead, 0-4)" << std::endl;
+    std::cout << "  -h, --help         Show this help" << std::endl;
+}
+
+// 64-bit FNV-1a over the framebuffer converted to ARGB
+static u64 hashFramebuffer(const u16* indices)
+{
+    static u32 fb[NES_WIDTH * NES_HEIGHT];
+    PPU::toARGB(indices, fb, NES_WIDTH * NES_HEIGHT);
+
+    u64 hash = 0xCBF29CE484222325ULL;
+    const u8* bytes = reinterpret_cast<const u8*>(fb);
+    for (size_t i = 0; i < NES_WIDTH * NES_HEIGHT * sizeof(u32); i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* rom_file = nullptr;
+    const char* hash_file = nullptr;
+    const char* wav_file = nullptr;
+    u64 frames = 600;
+    unsigned sample_rate = 44100;
+    int run_ahead = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        }
+        else if ((strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "--frames") == 0) && hasValue) {
+            auto parsed = vnes::util::parseInteger(argv[++i]);
+            if (!parsed) {
+                std::cerr << "Invalid frame count: " << argv[i] << std::endl;
+                return 1;
+            }
+            frames = *parsed;
+        }
+        else if ((strcmp(argv[i], "-H") == 0 || strcmp(argv[i], "--hashes") == 0) && hasValue) {
+            hash_file = argv[++i];
+        }
+        else if ((strcmp(argv[i], "-w") == 0 || strcmp(argv[i], "--wav") == 0) && hasValue) {
+            wav_file = argv[++i];
+        }
+        else if ((strcmp(argv[i], "-r") == 0 || strcmp(argv[i], "--rate") == 0) && hasValue) {
+            auto parsed = vnes::util::parseInteger(argv[++i]);
+            if (!parsed || *parsed < 8000 || *parsed > 192000) {
+                std::cerr << "Invalid sample rate: " << argv[i] << std::endl;
+                return 1;
+            }
+            sample_rate = static_cast<unsigned>(*parsed);
+        }
+        else if ((strcmp(argv[i], "-a") == 0 || strcmp(argv[i], "--run-ahead") == 0) && hasValue) {
+            auto parsed = vnes::util::parseInteger(argv[++i]);
+            if (!parsed || *parsed > 4) {
+                std::cerr << "Invalid run-ahead frame count: " << argv[i] << std::endl;
+                return 1;
+            }
+            run_ahead = static_cast<int>(*parsed);
+        }
+        else {
+            rom_file = argv[i];
+        }
+    }
+
+    if (!rom_file) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    Bus bus;
+    if (!bus.loadCartridge(rom_file)) {
+        std::cerr << "Failed to load ROM: " << rom_file << std::endl;
+        return 1;
+    }
+    bus.reset();
+    bus.apu.setSampleRate(sample_rate);
+
+    WavWriter wav(sample_rate);
+    if (wav_file) {
+        if (!wav.open(wav_file)) {
+            std::cerr << "Cannot open WAV output: " << wav_file << std::endl;
+            return 1;
+        }
+        bus.apu.setAudioSink(&wav);
+    }
+
+    std::ofstream hashes;
+    if (hash_file) {
+        hashes.open(hash_file);
+        if (!hashes) {
+            std::cerr << "Cannot open hash output: " << hash_file << std::endl;
+            return 1;
+        }
+    }
+
+    u64 hash = 0;
+    const auto start = std::chrono::steady_clock::now();
+
+    for (u64 frame = 0; frame < frames; frame++) {
+        bus.updateInput(0);
+        bus.runFrame();
+        bus.cartridge.signalFrameComplete();
+        bus.runAhead(run_ahead);
+
+        if (hashes.is_open()) {
+            hash = hashFramebuffer(bus.ppu.getFramebuffer());
+            hashes << frame << " " << toHex(hash, 16) << "\n";
+        }
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(end - start).count();
+
+    if (!hashes.is_open()) {
+        hash = hashFramebuffer(bus.ppu.getFramebuffer());
+    }
+
+    wav.close();
+    bus.cartridge.flushSRAM();
+
+    std::cout << "Frames:     " << frames << std::endl;
+    std::cout << "Time:       " << seconds << " s" << std::endl;
+    std::cout << "Speed:      " << (seconds > 0.0 ? frames / seconds : 0.0) << " FPS" << std::endl;
+    std::cout << "CPU cycles: " << bus.cpu.getCycles() << std::endl;
+    std::cout << "Final hash: " << toHex(hash, 16) << std::endl;
+    if (wav_file) {
+        std::cout << "Audio:      " << wav.getSampleCount() << " samples -> " << wav_file << std::endl;
+    }
+
+    return 0;
+}
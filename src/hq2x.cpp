@@ -42,17 +42,63 @@ uint32_t *HQ2x::resize(
 	bool wrapX,
 	bool wrapY ) const
 {
-	int lineSize = width * 2;
+	trY <<= 16;
+	trU <<= 8;
+	trA <<= 24;
+
+	prepare(image, width, height, trY, trU, trV, trA, wrapX, wrapY);
+	scale(output);
+	return output + width * height * 4;
+}
 
-	int previous, next;
-	uint32_t w[9];
 
+uint32_t *HQ2x::resizeIndexed(
+	const uint16_t *indices,
+	const uint32_t *palette,
+	uint32_t paletteSize,
+	uint32_t width,
+	uint32_t height,
+	uint32_t *output,
+	uint32_t trY,
+	uint32_t trU,
+	uint32_t trV,
+	uint32_t trA,
+	bool wrapX,
+	bool wrapY ) const
+{
 	trY <<= 16;
 	trU <<= 8;
 	trA <<= 24;
 
+	prepareIndexed(indices, palette, paletteSize, width, height, trY, trU, trV, trA, wrapX, wrapY);
+	scale(output);
+	return output + width * height * 4;
+}
+
+
+void HQ2x::blendRows(
+	const uint32_t *image,
+	const uint16_t *patterns,
+	uint32_t width,
+	uint32_t height,
+	uint32_t *output,
+	bool wrapX,
+	bool wrapY,
+	uint32_t rowBegin,
+	uint32_t rowEnd ) const
+{
+	int lineSize = width * 2;
+
+	int previous, next;
+	uint32_t w[9];
+
+	// each source row produces two output rows
+	image += rowBegin * width;
+	patterns += rowBegin * width;
+	output += rowBegin * width * 4;
+
 	// iterates between the lines
-	for (uint32_t row = 0; row < height; row++)
+	for (uint32_t row = rowBegin; row < rowEnd; row++)
 	{
 		/*
 		 * Note: this function uses a 3x3 sliding window over the original image.
@@ -140,20 +186,10 @@ uint32_t *HQ2x::resize(
 				}
 			}
 
-			int pattern = 0;
+			// the neighbour pattern (bits 0-7) and pair tests (DIFF_*)
+			const int pattern = *patterns++;
 
-			// computes the pattern to be used considering the neighbor pixels
-			for (int k = 0, flag = 1; k < 9; k++)
-			{
-				// ignores the central pixel
-				if (k == 4) continue;
-
-				if (w[k] != w[4])
-					if (HQx::isDifferent(w[4], w[k], trY, trU, trV, trA)) pattern |= flag;
-				flag <<= 1;
-			}
-
-			switch (pattern)
+			switch (pattern & 0xFF)
 			{
 				case 0:
 				case 1:
@@ -287,7 +323,7 @@ uint32_t *HQ2x::resize(
 				case 18:
 				case 50:
 					MIX_00_4_0_3_2_1_1
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4_2_3_1
 					}
@@ -303,7 +339,7 @@ uint32_t *HQ2x::resize(
 					MIX_00_4_3_1_2_1_1
 					MIX_01_4_2_1_2_1_1
 					MIX_10_4_6_3_2_1_1
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4_8_3_1
 					}
@@ -316,7 +352,7 @@ uint32_t *HQ2x::resize(
 				case 76:
 					MIX_00_4_0_1_2_1_1
 					MIX_01_4_1_5_2_1_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4_6_3_1
 					}
@@ -328,7 +364,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 10:
 				case 138:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4_0_3_1
 					}
@@ -387,7 +423,7 @@ uint32_t *HQ2x::resize(
 				case 22:
 				case 54:
 					MIX_00_4_0_3_2_1_1
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4
 					}
@@ -403,7 +439,7 @@ uint32_t *HQ2x::resize(
 					MIX_00_4_3_1_2_1_1
 					MIX_01_4_2_1_2_1_1
 					MIX_10_4_6_3_2_1_1
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4
 					}
@@ -416,7 +452,7 @@ uint32_t *HQ2x::resize(
 				case 108:
 					MIX_00_4_0_1_2_1_1
 					MIX_01_4_1_5_2_1_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4
 					}
@@ -428,7 +464,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 11:
 				case 139:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4
 					}
@@ -442,7 +478,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 19:
 				case 51:
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 					MIX_00_4_3_3_1
 					MIX_01_4_2_3_1
@@ -458,7 +494,7 @@ uint32_t *HQ2x::resize(
 				case 146:
 				case 178:
 					MIX_00_4_0_3_2_1_1
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 					MIX_01_4_2_3_1
 					MIX_11_4_7_3_1
@@ -473,7 +509,7 @@ uint32_t *HQ2x::resize(
 				case 84:
 				case 85:
 					MIX_00_4_3_1_2_1_1
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 					MIX_01_4_1_3_1
 					MIX_11_4_8_3_1
@@ -489,7 +525,7 @@ uint32_t *HQ2x::resize(
 				case 113:
 					MIX_00_4_3_1_2_1_1
 					MIX_01_4_2_1_2_1_1
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 					MIX_10_4_3_3_1
 					MIX_11_4_8_3_1
@@ -504,7 +540,7 @@ uint32_t *HQ2x::resize(
 				case 204:
 					MIX_00_4_0_1_2_1_1
 					MIX_01_4_1_5_2_1_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 					MIX_10_4_6_3_1
 					MIX_11_4_5_3_1
@@ -517,7 +553,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 73:
 				case 77:
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 					MIX_00_4_1_3_1
 					MIX_10_4_6_3_1
@@ -532,7 +568,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 42:
 				case 170:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 					MIX_00_4_0_3_1
 					MIX_10_4_7_3_1
@@ -547,7 +583,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 14:
 				case 142:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 					MIX_00_4_0_3_1
 					MIX_01_4_5_3_1
@@ -610,7 +646,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 26:
 				case 31:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4
 					}
@@ -618,7 +654,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_2_1_1
 					}
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4
 					}
@@ -632,7 +668,7 @@ uint32_t *HQ2x::resize(
 				case 82:
 				case 214:
 					MIX_00_4_0_3_2_1_1
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4
 					}
@@ -641,7 +677,7 @@ uint32_t *HQ2x::resize(
 						MIX_01_4_1_5_2_1_1
 					}
 					MIX_10_4_6_3_2_1_1
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4
 					}
@@ -654,7 +690,7 @@ uint32_t *HQ2x::resize(
 				case 248:
 					MIX_00_4_0_1_2_1_1
 					MIX_01_4_2_1_2_1_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4
 					}
@@ -662,7 +698,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_2_1_1
 					}
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4
 					}
@@ -673,7 +709,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 74:
 				case 107:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4
 					}
@@ -682,7 +718,7 @@ uint32_t *HQ2x::resize(
 						MIX_00_4_3_1_2_1_1
 					}
 					MIX_01_4_2_5_2_1_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4
 					}
@@ -693,7 +729,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_8_5_2_1_1
 					break;
 				case 27:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4
 					}
@@ -707,7 +743,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 86:
 					MIX_00_4_0_3_2_1_1
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4
 					}
@@ -722,7 +758,7 @@ uint32_t *HQ2x::resize(
 					MIX_00_4_0_1_2_1_1
 					MIX_01_4_2_1_2_1_1
 					MIX_10_4_6_3_1
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4
 					}
@@ -734,7 +770,7 @@ uint32_t *HQ2x::resize(
 				case 106:
 					MIX_00_4_0_3_1
 					MIX_01_4_2_5_2_1_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4
 					}
@@ -746,7 +782,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 30:
 					MIX_00_4_0_3_1
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4
 					}
@@ -761,7 +797,7 @@ uint32_t *HQ2x::resize(
 					MIX_00_4_0_3_2_1_1
 					MIX_01_4_2_3_1
 					MIX_10_4_6_3_2_1_1
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4
 					}
@@ -773,7 +809,7 @@ uint32_t *HQ2x::resize(
 				case 120:
 					MIX_00_4_0_1_2_1_1
 					MIX_01_4_2_1_2_1_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4
 					}
@@ -784,7 +820,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_8_3_1
 					break;
 				case 75:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4
 					}
@@ -869,7 +905,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_7_3_1
 					break;
 				case 58:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4_0_3_1
 					}
@@ -877,7 +913,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_6_1_1
 					}
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4_2_3_1
 					}
@@ -890,7 +926,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 83:
 					MIX_00_4_3_3_1
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4_2_3_1
 					}
@@ -899,7 +935,7 @@ uint32_t *HQ2x::resize(
 						MIX_01_4_1_5_6_1_1
 					}
 					MIX_10_4_6_3_2_1_1
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4_8_3_1
 					}
@@ -911,7 +947,7 @@ uint32_t *HQ2x::resize(
 				case 92:
 					MIX_00_4_0_1_2_1_1
 					MIX_01_4_1_3_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4_6_3_1
 					}
@@ -919,7 +955,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_6_1_1
 					}
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4_8_3_1
 					}
@@ -929,7 +965,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 202:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4_0_3_1
 					}
@@ -938,7 +974,7 @@ uint32_t *HQ2x::resize(
 						MIX_00_4_3_1_6_1_1
 					}
 					MIX_01_4_2_5_2_1_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4_6_3_1
 					}
@@ -949,7 +985,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_5_3_1
 					break;
 				case 78:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4_0_3_1
 					}
@@ -958,7 +994,7 @@ uint32_t *HQ2x::resize(
 						MIX_00_4_3_1_6_1_1
 					}
 					MIX_01_4_5_3_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4_6_3_1
 					}
@@ -969,7 +1005,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_8_5_2_1_1
 					break;
 				case 154:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4_0_3_1
 					}
@@ -977,7 +1013,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_6_1_1
 					}
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4_2_3_1
 					}
@@ -990,7 +1026,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 114:
 					MIX_00_4_0_3_2_1_1
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4_2_3_1
 					}
@@ -999,7 +1035,7 @@ uint32_t *HQ2x::resize(
 						MIX_01_4_1_5_6_1_1
 					}
 					MIX_10_4_3_3_1
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4_8_3_1
 					}
@@ -1011,7 +1047,7 @@ uint32_t *HQ2x::resize(
 				case 89:
 					MIX_00_4_1_3_1
 					MIX_01_4_2_1_2_1_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4_6_3_1
 					}
@@ -1019,7 +1055,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_6_1_1
 					}
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4_8_3_1
 					}
@@ -1029,7 +1065,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 90:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4_0_3_1
 					}
@@ -1037,7 +1073,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_6_1_1
 					}
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4_2_3_1
 					}
@@ -1045,7 +1081,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_01_4_1_5_6_1_1
 					}
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4_6_3_1
 					}
@@ -1053,7 +1089,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_6_1_1
 					}
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4_8_3_1
 					}
@@ -1064,7 +1100,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 55:
 				case 23:
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 					MIX_00_4_3_3_1
 					MIX_01_4
@@ -1080,7 +1116,7 @@ uint32_t *HQ2x::resize(
 				case 182:
 				case 150:
 					MIX_00_4_0_3_2_1_1
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 					MIX_01_4
 					MIX_11_4_7_3_1
@@ -1095,7 +1131,7 @@ uint32_t *HQ2x::resize(
 				case 213:
 				case 212:
 					MIX_00_4_3_1_2_1_1
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 					MIX_01_4_1_3_1
 					MIX_11_4
@@ -1111,7 +1147,7 @@ uint32_t *HQ2x::resize(
 				case 240:
 					MIX_00_4_3_1_2_1_1
 					MIX_01_4_2_1_2_1_1
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 					MIX_10_4_3_3_1
 					MIX_11_4
@@ -1126,7 +1162,7 @@ uint32_t *HQ2x::resize(
 				case 232:
 					MIX_00_4_0_1_2_1_1
 					MIX_01_4_1_5_2_1_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 					MIX_10_4
 					MIX_11_4_5_3_1
@@ -1139,7 +1175,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 109:
 				case 105:
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 					MIX_00_4_1_3_1
 					MIX_10_4
@@ -1154,7 +1190,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 171:
 				case 43:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 					MIX_00_4
 					MIX_10_4_7_3_1
@@ -1169,7 +1205,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 143:
 				case 15:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 					MIX_00_4
 					MIX_01_4_5_3_1
@@ -1185,7 +1221,7 @@ uint32_t *HQ2x::resize(
 				case 124:
 					MIX_00_4_0_1_2_1_1
 					MIX_01_4_1_3_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4
 					}
@@ -1196,7 +1232,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_8_3_1
 					break;
 				case 203:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4
 					}
@@ -1210,7 +1246,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 62:
 					MIX_00_4_0_3_1
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4
 					}
@@ -1225,7 +1261,7 @@ uint32_t *HQ2x::resize(
 					MIX_00_4_3_3_1
 					MIX_01_4_2_3_1
 					MIX_10_4_6_3_2_1_1
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4
 					}
@@ -1236,7 +1272,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 118:
 					MIX_00_4_0_3_2_1_1
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4
 					}
@@ -1251,7 +1287,7 @@ uint32_t *HQ2x::resize(
 					MIX_00_4_1_3_1
 					MIX_01_4_2_1_2_1_1
 					MIX_10_4_6_3_1
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4
 					}
@@ -1263,7 +1299,7 @@ uint32_t *HQ2x::resize(
 				case 110:
 					MIX_00_4_0_3_1
 					MIX_01_4_5_3_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4
 					}
@@ -1274,7 +1310,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_8_5_2_1_1
 					break;
 				case 155:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4
 					}
@@ -1337,7 +1373,7 @@ uint32_t *HQ2x::resize(
 				case 220:
 					MIX_00_4_0_1_2_1_1
 					MIX_01_4_1_3_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4_6_3_1
 					}
@@ -1345,7 +1381,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_6_1_1
 					}
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4
 					}
@@ -1355,7 +1391,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 158:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4_0_3_1
 					}
@@ -1363,7 +1399,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_6_1_1
 					}
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4
 					}
@@ -1375,7 +1411,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_7_3_1
 					break;
 				case 234:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4_0_3_1
 					}
@@ -1384,7 +1420,7 @@ uint32_t *HQ2x::resize(
 						MIX_00_4_3_1_6_1_1
 					}
 					MIX_01_4_2_5_2_1_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4
 					}
@@ -1396,7 +1432,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 242:
 					MIX_00_4_0_3_2_1_1
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4_2_3_1
 					}
@@ -1405,7 +1441,7 @@ uint32_t *HQ2x::resize(
 						MIX_01_4_1_5_6_1_1
 					}
 					MIX_10_4_3_3_1
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4
 					}
@@ -1415,7 +1451,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 59:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4
 					}
@@ -1423,7 +1459,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_2_1_1
 					}
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4_2_3_1
 					}
@@ -1437,7 +1473,7 @@ uint32_t *HQ2x::resize(
 				case 121:
 					MIX_00_4_1_3_1
 					MIX_01_4_2_1_2_1_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4
 					}
@@ -1445,7 +1481,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_2_1_1
 					}
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4_8_3_1
 					}
@@ -1456,7 +1492,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 87:
 					MIX_00_4_3_3_1
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4
 					}
@@ -1465,7 +1501,7 @@ uint32_t *HQ2x::resize(
 						MIX_01_4_1_5_2_1_1
 					}
 					MIX_10_4_6_3_2_1_1
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4_8_3_1
 					}
@@ -1475,7 +1511,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 79:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4
 					}
@@ -1484,7 +1520,7 @@ uint32_t *HQ2x::resize(
 						MIX_00_4_3_1_2_1_1
 					}
 					MIX_01_4_5_3_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4_6_3_1
 					}
@@ -1495,7 +1531,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_8_5_2_1_1
 					break;
 				case 122:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4_0_3_1
 					}
@@ -1503,7 +1539,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_6_1_1
 					}
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4_2_3_1
 					}
@@ -1511,7 +1547,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_01_4_1_5_6_1_1
 					}
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4
 					}
@@ -1519,7 +1555,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_2_1_1
 					}
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4_8_3_1
 					}
@@ -1529,7 +1565,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 94:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4_0_3_1
 					}
@@ -1537,7 +1573,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_6_1_1
 					}
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4
 					}
@@ -1545,7 +1581,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_01_4_1_5_2_1_1
 					}
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4_6_3_1
 					}
@@ -1553,7 +1589,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_6_1_1
 					}
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4_8_3_1
 					}
@@ -1563,7 +1599,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 218:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4_0_3_1
 					}
@@ -1571,7 +1607,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_6_1_1
 					}
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4_2_3_1
 					}
@@ -1579,7 +1615,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_01_4_1_5_6_1_1
 					}
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4_6_3_1
 					}
@@ -1587,7 +1623,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_6_1_1
 					}
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4
 					}
@@ -1597,7 +1633,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 91:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4
 					}
@@ -1605,7 +1641,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_2_1_1
 					}
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4_2_3_1
 					}
@@ -1613,7 +1649,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_01_4_1_5_6_1_1
 					}
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4_6_3_1
 					}
@@ -1621,7 +1657,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_6_1_1
 					}
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4_8_3_1
 					}
@@ -1655,7 +1691,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_7_3_1
 					break;
 				case 186:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4_0_3_1
 					}
@@ -1663,7 +1699,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_6_1_1
 					}
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4_2_3_1
 					}
@@ -1676,7 +1712,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 115:
 					MIX_00_4_3_3_1
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4_2_3_1
 					}
@@ -1685,7 +1721,7 @@ uint32_t *HQ2x::resize(
 						MIX_01_4_1_5_6_1_1
 					}
 					MIX_10_4_3_3_1
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4_8_3_1
 					}
@@ -1697,7 +1733,7 @@ uint32_t *HQ2x::resize(
 				case 93:
 					MIX_00_4_1_3_1
 					MIX_01_4_1_3_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4_6_3_1
 					}
@@ -1705,7 +1741,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_6_1_1
 					}
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4_8_3_1
 					}
@@ -1715,7 +1751,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 206:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4_0_3_1
 					}
@@ -1724,7 +1760,7 @@ uint32_t *HQ2x::resize(
 						MIX_00_4_3_1_6_1_1
 					}
 					MIX_01_4_5_3_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4_6_3_1
 					}
@@ -1738,7 +1774,7 @@ uint32_t *HQ2x::resize(
 				case 201:
 					MIX_00_4_1_3_1
 					MIX_01_4_1_5_2_1_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4_6_3_1
 					}
@@ -1750,7 +1786,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 174:
 				case 46:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4_0_3_1
 					}
@@ -1765,7 +1801,7 @@ uint32_t *HQ2x::resize(
 				case 179:
 				case 147:
 					MIX_00_4_3_3_1
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4_2_3_1
 					}
@@ -1781,7 +1817,7 @@ uint32_t *HQ2x::resize(
 					MIX_00_4_3_1_2_1_1
 					MIX_01_4_1_3_1
 					MIX_10_4_3_3_1
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4_8_3_1
 					}
@@ -1804,7 +1840,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 126:
 					MIX_00_4_0_3_1
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4
 					}
@@ -1812,7 +1848,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_01_4_1_5_2_1_1
 					}
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4
 					}
@@ -1823,7 +1859,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_8_3_1
 					break;
 				case 219:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4
 					}
@@ -1833,7 +1869,7 @@ uint32_t *HQ2x::resize(
 					}
 					MIX_01_4_2_3_1
 					MIX_10_4_6_3_1
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4
 					}
@@ -1843,7 +1879,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 125:
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 					MIX_00_4_1_3_1
 					MIX_10_4
@@ -1858,7 +1894,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 221:
 					MIX_00_4_1_3_1
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 					MIX_01_4_1_3_1
 					MIX_11_4
@@ -1871,7 +1907,7 @@ uint32_t *HQ2x::resize(
 					MIX_10_4_6_3_1
 					break;
 				case 207:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 					MIX_00_4
 					MIX_01_4_5_3_1
@@ -1887,7 +1923,7 @@ uint32_t *HQ2x::resize(
 				case 238:
 					MIX_00_4_0_3_1
 					MIX_01_4_5_3_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 					MIX_10_4
 					MIX_11_4_5_3_1
@@ -1900,7 +1936,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 190:
 					MIX_00_4_0_3_1
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 					MIX_01_4
 					MIX_11_4_7_3_1
@@ -1913,7 +1949,7 @@ uint32_t *HQ2x::resize(
 					MIX_10_4_7_3_1
 					break;
 				case 187:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 					MIX_00_4
 					MIX_10_4_7_3_1
@@ -1929,7 +1965,7 @@ uint32_t *HQ2x::resize(
 				case 243:
 					MIX_00_4_3_3_1
 					MIX_01_4_2_3_1
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 					MIX_10_4_3_3_1
 					MIX_11_4
@@ -1941,7 +1977,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 119:
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 					MIX_00_4_3_3_1
 					MIX_01_4
@@ -1958,7 +1994,7 @@ uint32_t *HQ2x::resize(
 				case 233:
 					MIX_00_4_1_3_1
 					MIX_01_4_1_5_2_1_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4
 					}
@@ -1970,7 +2006,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 175:
 				case 47:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4
 					}
@@ -1985,7 +2021,7 @@ uint32_t *HQ2x::resize(
 				case 183:
 				case 151:
 					MIX_00_4_3_3_1
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4
 					}
@@ -2001,7 +2037,7 @@ uint32_t *HQ2x::resize(
 					MIX_00_4_3_1_2_1_1
 					MIX_01_4_1_3_1
 					MIX_10_4_3_3_1
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4
 					}
@@ -2013,7 +2049,7 @@ uint32_t *HQ2x::resize(
 				case 250:
 					MIX_00_4_0_3_1
 					MIX_01_4_2_3_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4
 					}
@@ -2021,7 +2057,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_2_1_1
 					}
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4
 					}
@@ -2031,7 +2067,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 123:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4
 					}
@@ -2040,7 +2076,7 @@ uint32_t *HQ2x::resize(
 						MIX_00_4_3_1_2_1_1
 					}
 					MIX_01_4_2_3_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4
 					}
@@ -2051,7 +2087,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_8_3_1
 					break;
 				case 95:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4
 					}
@@ -2059,7 +2095,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_2_1_1
 					}
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4
 					}
@@ -2072,7 +2108,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 222:
 					MIX_00_4_0_3_1
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4
 					}
@@ -2081,7 +2117,7 @@ uint32_t *HQ2x::resize(
 						MIX_01_4_1_5_2_1_1
 					}
 					MIX_10_4_6_3_1
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4
 					}
@@ -2093,7 +2129,7 @@ uint32_t *HQ2x::resize(
 				case 252:
 					MIX_00_4_0_1_2_1_1
 					MIX_01_4_1_3_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4
 					}
@@ -2101,7 +2137,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_2_1_1
 					}
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4
 					}
@@ -2113,7 +2149,7 @@ uint32_t *HQ2x::resize(
 				case 249:
 					MIX_00_4_1_3_1
 					MIX_01_4_2_1_2_1_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4
 					}
@@ -2121,7 +2157,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_e_1_1
 					}
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4
 					}
@@ -2131,7 +2167,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 235:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4
 					}
@@ -2140,7 +2176,7 @@ uint32_t *HQ2x::resize(
 						MIX_00_4_3_1_2_1_1
 					}
 					MIX_01_4_2_5_2_1_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4
 					}
@@ -2151,7 +2187,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_5_3_1
 					break;
 				case 111:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4
 					}
@@ -2160,7 +2196,7 @@ uint32_t *HQ2x::resize(
 						MIX_00_4_3_1_e_1_1
 					}
 					MIX_01_4_5_3_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4
 					}
@@ -2171,7 +2207,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_8_5_2_1_1
 					break;
 				case 63:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4
 					}
@@ -2179,7 +2215,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_e_1_1
 					}
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4
 					}
@@ -2191,7 +2227,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_8_7_2_1_1
 					break;
 				case 159:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4
 					}
@@ -2199,7 +2235,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_2_1_1
 					}
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4
 					}
@@ -2212,7 +2248,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 215:
 					MIX_00_4_3_3_1
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4
 					}
@@ -2221,7 +2257,7 @@ uint32_t *HQ2x::resize(
 						MIX_01_4_1_5_e_1_1
 					}
 					MIX_10_4_6_3_2_1_1
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4
 					}
@@ -2232,7 +2268,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 246:
 					MIX_00_4_0_3_2_1_1
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4
 					}
@@ -2241,7 +2277,7 @@ uint32_t *HQ2x::resize(
 						MIX_01_4_1_5_2_1_1
 					}
 					MIX_10_4_3_3_1
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4
 					}
@@ -2252,7 +2288,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 254:
 					MIX_00_4_0_3_1
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4
 					}
@@ -2260,7 +2296,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_01_4_1_5_2_1_1
 					}
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4
 					}
@@ -2268,7 +2304,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_2_1_1
 					}
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4
 					}
@@ -2280,7 +2316,7 @@ uint32_t *HQ2x::resize(
 				case 253:
 					MIX_00_4_1_3_1
 					MIX_01_4_1_3_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4
 					}
@@ -2288,7 +2324,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_e_1_1
 					}
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4
 					}
@@ -2298,7 +2334,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 251:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4
 					}
@@ -2307,7 +2343,7 @@ uint32_t *HQ2x::resize(
 						MIX_00_4_3_1_2_1_1
 					}
 					MIX_01_4_2_3_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4
 					}
@@ -2315,7 +2351,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_10_4_7_3_e_1_1
 					}
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4
 					}
@@ -2325,7 +2361,7 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 239:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4
 					}
@@ -2334,7 +2370,7 @@ uint32_t *HQ2x::resize(
 						MIX_00_4_3_1_e_1_1
 					}
 					MIX_01_4_5_3_1
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4
 					}
@@ -2345,7 +2381,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_5_3_1
 					break;
 				case 127:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4
 					}
@@ -2353,7 +2389,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_e_1_1
 					}
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4
 					}
@@ -2361,7 +2397,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_01_4_1_5_2_1_1
 					}
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 					{
 						MIX_10_4
 					}
@@ -2372,7 +2408,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_8_3_1
 					break;
 				case 191:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4
 					}
@@ -2380,7 +2416,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_e_1_1
 					}
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4
 					}
@@ -2392,7 +2428,7 @@ uint32_t *HQ2x::resize(
 					MIX_11_4_7_3_1
 					break;
 				case 223:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 					{
 						MIX_00_4
 					}
@@ -2400,7 +2436,7 @@ uint32_t *HQ2x::resize(
 					{
 						MIX_00_4_3_1_2_1_1
 					}
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4
 					}
@@ -2409,7 +2445,7 @@ uint32_t *HQ2x::resize(
 						MIX_01_4_1_5_e_1_1
 					}
 					MIX_10_4_6_3_1
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4
 					}
@@ -2420,7 +2456,7 @@ uint32_t *HQ2x::resize(
 					break;
 				case 247:
 					MIX_00_4_3_3_1
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 					{
 						MIX_01_4
 					}
@@ -2429,7 +2465,7 @@ uint32_t *HQ2x::resize(
 						MIX_01_4_1_5_e_1_1
 					}
 					MIX_10_4_3_3_1
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 					{
 						MIX_11_4
 					}
@@ -2439,22 +2475,22 @@ uint32_t *HQ2x::resize(
 					}
 					break;
 				case 255:
-					if (HQx::isDifferent(w[3], w[1], trY, trU, trV, trA))
+					if (pattern & DIFF_3_1)
 						MIX_00_4
 					else
 						MIX_00_4_3_1_e_1_1
 
-					if (HQx::isDifferent(w[1], w[5], trY, trU, trV, trA))
+					if (pattern & DIFF_1_5)
 						MIX_01_4
 					else
 						MIX_01_4_1_5_e_1_1
 
-					if (HQx::isDifferent(w[7], w[3], trY, trU, trV, trA))
+					if (pattern & DIFF_7_3)
 						MIX_10_4
 					else
 						MIX_10_4_7_3_e_1_1
 
-					if (HQx::isDifferent(w[5], w[7], trY, trU, trV, trA))
+					if (pattern & DIFF_5_7)
 						MIX_11_4
 					else
 						MIX_11_4_5_7_e_1_1
@@ -2465,6 +2501,4 @@ uint32_t *HQ2x::resize(
 		}
 		output += lineSize;
 	}
-
-	return output;
 }
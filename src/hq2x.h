@@ -40,6 +40,38 @@ class HQ2x : public HQx
 			uint32_t trA = 0x50,
 			bool wrapX = false,
 			bool wrapY = false ) const;
+
+		/**
+		 * @brief Scales a palette-indexed image (e.g. the NES framebuffer).
+		 *
+		 * Same output as resize() on the expanded ARGB image, but the
+		 * neighbour tests are palette table lookups (see prepareIndexed).
+		 */
+		uint32_t *resizeIndexed(
+			const uint16_t *indices,
+			const uint32_t *palette,
+			uint32_t paletteSize,
+			uint32_t width,
+			uint32_t height,
+			uint32_t *output,
+			uint32_t trY = 0x30,
+			uint32_t trU = 0x07,
+			uint32_t trV = 0x06,
+			uint32_t trA = 0x50,
+			bool wrapX = false,
+			bool wrapY = false ) const;
+
+	protected:
+		void blendRows(
+			const uint32_t *image,
+			const uint16_t *patterns,
+			uint32_t width,
+			uint32_t height,
+			uint32_t *output,
+			bool wrapX,
+			bool wrapY,
+			uint32_t rowBegin,
+			uint32_t rowEnd ) const;
 };
 
 
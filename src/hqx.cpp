@@ -1,8 +1,16 @@
 #include "hqx.h"
+#include "worker_pool.h"
 
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
 
 HQx::HQx()
+	: frame_()
+	, diffThresholds_()
+	, diffAlways_(false)
+	, diffRgba_(false)
+	, rgbaPalette_(false)
 {
 }
 
@@ -43,3 +51,634 @@ bool HQx::isDifferent(
 		std::abs(static_cast<int>((ayuv1 >> 8) & 0xFFU) - static_cast<int>((ayuv2 >> 8) & 0xFFU)) > static_cast<int>(trU) ||
 		std::abs(static_cast<int>(ayuv1 & 0xFFU) - static_cast<int>(ayuv2 & 0xFFU)) > static_cast<int>(trV);
 }
+
+
+// ---------------------------------------------------------------------------
+// Neighbour pattern analysis
+// ---------------------------------------------------------------------------
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define HQX_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define HQX_TARGET(isa)
+#else
+#define HQX_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+namespace
+{
+	// isDifferent() thresholds as unsigned per-byte limits of an AYUV value
+	// (byte 0 = V ... byte 3 = A). isDifferent() compares against the int
+	// value of the shifted threshold, so anything >= 255 can never trigger
+	// and a negative one (e.g. trA >= 0x80) always does.
+	struct Thresholds
+	{
+		uint32_t bytes;
+		bool always;
+	};
+
+	Thresholds makeThresholds(uint32_t trY, uint32_t trU, uint32_t trV, uint32_t trA)
+	{
+		const uint32_t tr[4] = { trV, trU, trY, trA };
+		Thresholds t = { 0, false };
+		for (int i = 0; i < 4; i++)
+		{
+			const int value = static_cast<int>(tr[i]);
+			if (value < 0)
+				t.always = true;
+			else
+				t.bytes |= static_cast<uint32_t>(value > 0xFF ? 0xFF : value) << (i * 8);
+		}
+		return t;
+	}
+
+	inline bool differs(uint32_t yuv1, uint32_t yuv2, const Thresholds& t)
+	{
+		if (t.always) return true;
+		for (int shift = 0; shift < 32; shift += 8)
+		{
+			const int d = std::abs(static_cast<int>((yuv1 >> shift) & 0xFFU) - static_cast<int>((yuv2 >> shift) & 0xFFU));
+			if (d > static_cast<int>((t.bytes >> shift) & 0xFFU)) return true;
+		}
+		return false;
+	}
+
+	// Window position of neighbours w0..w8 (skipping w4), as row (0 = above)
+	// and column offset
+	const int NEIGHBOUR_ROW[8] = { 0, 0, 0, 1, 1, 2, 2, 2 };
+	const int NEIGHBOUR_DX[8] = { -1, 0, 1, -1, 1, -1, 0, 1 };
+
+	struct Rows
+	{
+		const uint32_t *rgb[3];
+		const uint32_t *yuv[3];
+	};
+
+	// One pixel with explicit left/right columns, used at the image edges
+	// where the window wraps or is clamped, and for the tail of a row
+	uint16_t pixelPattern(const Rows& rows, uint32_t left, uint32_t col, uint32_t right, const Thresholds& t)
+	{
+		const uint32_t x[3] = { left, col, right };
+		uint32_t rgb[9], yuv[9];
+		for (int r = 0; r < 3; r++)
+		{
+			for (int c = 0; c < 3; c++)
+			{
+				rgb[r * 3 + c] = rows.rgb[r][x[c]];
+				yuv[r * 3 + c] = rows.yuv[r][x[c]];
+			}
+		}
+
+		uint16_t pattern = 0;
+		for (int k = 0, flag = 1; k < 9; k++)
+		{
+			if (k == 4) continue;
+			if (rgb[k] != rgb[4] && differs(yuv[4], yuv[k], t)) pattern |= flag;
+			flag <<= 1;
+		}
+
+		// HQx::DIFF_1_5, DIFF_3_1, DIFF_5_7, DIFF_7_3
+		if (differs(yuv[1], yuv[5], t)) pattern |= 0x100;
+		if (differs(yuv[3], yuv[1], t)) pattern |= 0x200;
+		if (differs(yuv[5], yuv[7], t)) pattern |= 0x400;
+		if (differs(yuv[7], yuv[3], t)) pattern |= 0x800;
+		return pattern;
+	}
+
+	// Processes whole blocks of columns in [begin, end), where both horizontal
+	// neighbours are inside the row, and returns the first column left over
+	typedef uint32_t (*RowKernel)(const Rows& rows, uint16_t *out, uint32_t begin, uint32_t end, const Thresholds& t);
+
+	uint32_t patternRowScalar(const Rows& rows, uint16_t *out, uint32_t begin, uint32_t end, const Thresholds& t)
+	{
+		for (uint32_t x = begin; x < end; x++)
+			out[x] = pixelPattern(rows, x - 1, x, x + 1, t);
+		return end;
+	}
+
+#if defined(HQX_X86)
+	HQX_TARGET("sse4.1")
+	inline __m128i differs128(__m128i a, __m128i b, __m128i thresholds, __m128i always)
+	{
+		const __m128i diff = _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+		const __m128i within = _mm_cmpeq_epi32(_mm_subs_epu8(diff, thresholds), _mm_setzero_si128());
+		return _mm_or_si128(_mm_xor_si128(within, _mm_set1_epi32(-1)), always);
+	}
+
+	HQX_TARGET("sse4.1")
+	uint32_t patternRowSse41(const Rows& rows, uint16_t *out, uint32_t begin, uint32_t end, const Thresholds& t)
+	{
+		const __m128i thresholds = _mm_set1_epi32(static_cast<int>(t.bytes));
+		const __m128i always = _mm_set1_epi32(t.always ? -1 : 0);
+
+		uint32_t x = begin;
+		for (; x + 4 <= end; x += 4)
+		{
+			const __m128i rgb4 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rows.rgb[1] + x));
+			const __m128i yuv4 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rows.yuv[1] + x));
+
+			__m128i yuv[8];
+			__m128i pattern = _mm_setzero_si128();
+			for (int k = 0; k < 8; k++)
+			{
+				const uint32_t offset = x + NEIGHBOUR_DX[k];
+				const __m128i rgb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rows.rgb[NEIGHBOUR_ROW[k]] + offset));
+				yuv[k] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rows.yuv[NEIGHBOUR_ROW[k]] + offset));
+
+				const __m128i different = _mm_andnot_si128(_mm_cmpeq_epi32(rgb, rgb4), differs128(yuv4, yuv[k], thresholds, always));
+				pattern = _mm_or_si128(pattern, _mm_and_si128(different, _mm_set1_epi32(1 << k)));
+			}
+
+			// yuv[] skips the centre: w1 = [1], w3 = [3], w5 = [4], w7 = [6]
+			pattern = _mm_or_si128(pattern, _mm_and_si128(differs128(yuv[1], yuv[4], thresholds, always), _mm_set1_epi32(0x100)));
+			pattern = _mm_or_si128(pattern, _mm_and_si128(differs128(yuv[3], yuv[1], thresholds, always), _mm_set1_epi32(0x200)));
+			pattern = _mm_or_si128(pattern, _mm_and_si128(differs128(yuv[4], yuv[6], thresholds, always), _mm_set1_epi32(0x400)));
+			pattern = _mm_or_si128(pattern, _mm_and_si128(differs128(yuv[6], yuv[3], thresholds, always), _mm_set1_epi32(0x800)));
+
+			_mm_storel_epi64(reinterpret_cast<__m128i *>(out + x), _mm_packus_epi32(pattern, pattern));
+		}
+		return x;
+	}
+
+	HQX_TARGET("avx2")
+	inline __m256i differs256(__m256i a, __m256i b, __m256i thresholds, __m256i always)
+	{
+		const __m256i diff = _mm256_or_si256(_mm256_subs_epu8(a, b), _mm256_subs_epu8(b, a));
+		const __m256i within = _mm256_cmpeq_epi32(_mm256_subs_epu8(diff, thresholds), _mm256_setzero_si256());
+		return _mm256_or_si256(_mm256_xor_si256(within, _mm256_set1_epi32(-1)), always);
+	}
+
+	HQX_TARGET("avx2")
+	uint32_t patternRowAvx2(const Rows& rows, uint16_t *out, uint32_t begin, uint32_t end, const Thresholds& t)
+	{
+		const __m256i thresholds = _mm256_set1_epi32(static_cast<int>(t.bytes));
+		const __m256i always = _mm256_set1_epi32(t.always ? -1 : 0);
+
+		uint32_t x = begin;
+		for (; x + 8 <= end; x += 8)
+		{
+			const __m256i rgb4 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rows.rgb[1] + x));
+			const __m256i yuv4 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rows.yuv[1] + x));
+
+			__m256i yuv[8];
+			__m256i pattern = _mm256_setzero_si256();
+			for (int k = 0; k < 8; k++)
+			{
+				const uint32_t offset = x + NEIGHBOUR_DX[k];
+				const __m256i rgb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rows.rgb[NEIGHBOUR_ROW[k]] + offset));
+				yuv[k] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rows.yuv[NEIGHBOUR_ROW[k]] + offset));
+
+				const __m256i different = _mm256_andnot_si256(_mm256_cmpeq_epi32(rgb, rgb4), differs256(yuv4, yuv[k], thresholds, always));
+				pattern = _mm256_or_si256(pattern, _mm256_and_si256(different, _mm256_set1_epi32(1 << k)));
+			}
+
+			pattern = _mm256_or_si256(pattern, _mm256_and_si256(differs256(yuv[1], yuv[4], thresholds, always), _mm256_set1_epi32(0x100)));
+			pattern = _mm256_or_si256(pattern, _mm256_and_si256(differs256(yuv[3], yuv[1], thresholds, always), _mm256_set1_epi32(0x200)));
+			pattern = _mm256_or_si256(pattern, _mm256_and_si256(differs256(yuv[4], yuv[6], thresholds, always), _mm256_set1_epi32(0x400)));
+			pattern = _mm256_or_si256(pattern, _mm256_and_si256(differs256(yuv[6], yuv[3], thresholds, always), _mm256_set1_epi32(0x800)));
+
+			// packus works per 128-bit lane; gather the two low halves
+			const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(pattern, pattern), 0x08);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(out + x), _mm256_castsi256_si128(packed));
+		}
+		return x;
+	}
+#endif
+
+	struct Kernel
+	{
+		RowKernel row;
+		const char *name;
+	};
+
+	// Every kernel this CPU can run, fastest first
+	std::vector<Kernel> availableKernels()
+	{
+		std::vector<Kernel> kernels;
+#if defined(HQX_X86)
+#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		const int maxLeaf = info[0];
+		__cpuid(info, 1);
+		const bool sse41 = (info[2] & (1 << 19)) != 0;
+		// AVX2 also needs the OS to save the YMM registers (OSXSAVE + XCR0)
+		bool avx2 = false;
+		if (maxLeaf >= 7 && (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6)
+		{
+			__cpuidex(info, 7, 0);
+			avx2 = (info[1] & (1 << 5)) != 0;
+		}
+#else
+		__builtin_cpu_init();
+		const bool sse41 = __builtin_cpu_supports("sse4.1");
+		const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+		if (avx2) kernels.push_back({ patternRowAvx2, "avx2" });
+		if (sse41) kernels.push_back({ patternRowSse41, "sse4.1" });
+#endif
+		kernels.push_back({ patternRowScalar, "scalar" });
+		return kernels;
+	}
+
+	const std::vector<Kernel>& kernels()
+	{
+		static const std::vector<Kernel> available = availableKernels();
+		return available;
+	}
+
+	// The fastest one unless HQx::setKernel() picked another
+	Kernel& kernel()
+	{
+		static Kernel selected = kernels().front();
+		return selected;
+	}
+
+	struct DiffTable
+	{
+		const uint64_t *bits;
+		uint32_t words;     // per row
+		bool always;        // pair tests ignore colour equality
+
+		bool get(uint32_t a, uint32_t b) const
+		{
+			return (bits[a * words + (b >> 6)] >> (b & 63)) & 1;
+		}
+	};
+
+	// pixelPattern() for palette indices
+	inline uint16_t indexedPattern(const uint16_t *const rows[3], uint32_t left, uint32_t col, uint32_t right, const DiffTable& t)
+	{
+		const uint32_t x[3] = { left, col, right };
+		uint32_t w[9];
+		for (int r = 0; r < 3; r++)
+		{
+			for (int c = 0; c < 3; c++)
+				w[r * 3 + c] = rows[r][x[c]];
+		}
+
+		uint16_t pattern = 0;
+		for (int k = 0, flag = 1; k < 9; k++)
+		{
+			if (k == 4) continue;
+			if (t.get(w[4], w[k])) pattern |= flag;
+			flag <<= 1;
+		}
+
+		if (t.always || t.get(w[1], w[5])) pattern |= 0x100;
+		if (t.always || t.get(w[3], w[1])) pattern |= 0x200;
+		if (t.always || t.get(w[5], w[7])) pattern |= 0x400;
+		if (t.always || t.get(w[7], w[3])) pattern |= 0x800;
+		return pattern;
+	}
+
+	// Frames with at most 64 distinct values use per-frame ids, so a row of
+	// the difference table is a single mask: bit b of masks[a] is set when
+	// ids a and b are different colours
+	const uint32_t MAX_DENSE_COLORS = 64;
+
+	inline uint16_t densePattern(const uint8_t *const rows[3], uint32_t left, uint32_t col, uint32_t right,
+		const uint64_t *masks, bool always)
+	{
+		const uint64_t m = masks[rows[1][col]];
+		const uint32_t w1 = rows[0][col], w3 = rows[1][left], w5 = rows[1][right], w7 = rows[2][col];
+
+		uint32_t pattern =
+			static_cast<uint32_t>((m >> rows[0][left]) & 1) |
+			static_cast<uint32_t>(((m >> w1) & 1) << 1) |
+			static_cast<uint32_t>(((m >> rows[0][right]) & 1) << 2) |
+			static_cast<uint32_t>(((m >> w3) & 1) << 3) |
+			static_cast<uint32_t>(((m >> w5) & 1) << 4) |
+			static_cast<uint32_t>(((m >> rows[2][left]) & 1) << 5) |
+			static_cast<uint32_t>(((m >> w7) & 1) << 6) |
+			static_cast<uint32_t>(((m >> rows[2][right]) & 1) << 7);
+
+		if (always)
+			pattern |= 0xF00;
+		else
+			pattern |=
+				static_cast<uint32_t>(((masks[w1] >> w5) & 1) << 8) |
+				static_cast<uint32_t>(((masks[w3] >> w1) & 1) << 9) |
+				static_cast<uint32_t>(((masks[w5] >> w7) & 1) << 10) |
+				static_cast<uint32_t>(((masks[w7] >> w3) & 1) << 11);
+		return static_cast<uint16_t>(pattern);
+	}
+}
+
+namespace
+{
+	// Runs pixel(rows, left, col, right) for rows [rowBegin, rowEnd) of a
+	// plane of per-pixel keys, with the edge columns and rows wrapped or
+	// clamped like the kernels' sliding window
+	template <typename T, typename Pixel>
+	void patternRows(const T *plane, uint32_t width, uint32_t height, bool wrapX, bool wrapY,
+		uint32_t rowBegin, uint32_t rowEnd, uint16_t *patterns, Pixel pixel)
+	{
+		const uint32_t firstLeft = wrapX ? width - 1 : 0;
+		const uint32_t lastRight = wrapX ? 0 : width - 1;
+
+		for (uint32_t row = rowBegin; row < rowEnd; row++)
+		{
+			const uint32_t above = row > 0 ? row - 1 : (wrapY ? height - 1 : row);
+			const uint32_t below = row < height - 1 ? row + 1 : (wrapY ? 0 : row);
+			const T *const rows[3] = {
+				plane + static_cast<size_t>(above) * width,
+				plane + static_cast<size_t>(row) * width,
+				plane + static_cast<size_t>(below) * width
+			};
+			uint16_t *out = patterns + static_cast<size_t>(row) * width;
+
+			if (width == 1)
+			{
+				out[0] = pixel(rows, firstLeft, 0, lastRight);
+				continue;
+			}
+
+			out[0] = pixel(rows, firstLeft, 0, 1);
+			for (uint32_t x = 1; x < width - 1; x++)
+				out[x] = pixel(rows, x - 1, x, x + 1);
+			out[width - 1] = pixel(rows, width - 2, width - 1, lastRight);
+		}
+	}
+}
+
+const char *HQx::getKernelName()
+{
+	return kernel().name;
+}
+
+std::vector<const char *> HQx::getKernelNames()
+{
+	std::vector<const char *> names;
+	for (const Kernel& k : kernels())
+		names.push_back(k.name);
+	return names;
+}
+
+bool HQx::setKernel(const char *name)
+{
+	for (const Kernel& k : kernels())
+	{
+		if (std::strcmp(k.name, name) == 0)
+		{
+			kernel() = k;
+			return true;
+		}
+	}
+	return false;
+}
+
+void HQx::setThreadCount(unsigned threads)
+{
+	if (threads == 0) threads = 1;
+	if (threads == getThreadCount()) return;
+
+	if (threads == 1)
+		pool_.reset();
+	else if (pool_)
+		pool_->setThreadCount(threads);
+	else
+		pool_.reset(new WorkerPool(threads));
+}
+
+unsigned HQx::getThreadCount() const
+{
+	return pool_ ? pool_->getThreadCount() : 1;
+}
+
+void HQx::setRgbaPalette(bool rgba)
+{
+	rgbaPalette_ = rgba;
+}
+
+bool HQx::getRgbaPalette() const
+{
+	return rgbaPalette_;
+}
+
+void HQx::prepare(
+	const uint32_t *image,
+	uint32_t width,
+	uint32_t height,
+	uint32_t trY,
+	uint32_t trU,
+	uint32_t trV,
+	uint32_t trA,
+	bool wrapX,
+	bool wrapY ) const
+{
+	const size_t pixels = static_cast<size_t>(width) * height;
+	yuv_.resize(pixels);
+	patterns_.resize(pixels);
+
+	for (size_t i = 0; i < pixels; i++)
+		yuv_[i] = ARGBtoAYUV(image[i]);
+
+	const Thresholds t = makeThresholds(trY, trU, trV, trA);
+	frame_.image = image;
+	frame_.indexed = false;
+	frame_.width = width;
+	frame_.height = height;
+	frame_.wrapX = wrapX;
+	frame_.wrapY = wrapY;
+	frame_.thresholds = t.bytes;
+	frame_.always = t.always;
+}
+
+void HQx::updateDiffTable(
+	const uint32_t *palette,
+	uint32_t paletteSize,
+	uint32_t trY,
+	uint32_t trU,
+	uint32_t trV,
+	uint32_t trA ) const
+{
+	const uint32_t thresholds[4] = { trY, trU, trV, trA };
+	if (diffPalette_.size() == paletteSize && diffRgba_ == rgbaPalette_ &&
+		std::memcmp(diffThresholds_, thresholds, sizeof(thresholds)) == 0 &&
+		std::memcmp(diffPalette_.data(), palette, paletteSize * sizeof(uint32_t)) == 0)
+		return;
+
+	diffPalette_.assign(palette, palette + paletteSize);
+	std::memcpy(diffThresholds_, thresholds, sizeof(thresholds));
+	diffRgba_ = rgbaPalette_;
+
+	const Thresholds t = makeThresholds(trY, trU, trV, trA);
+	diffAlways_ = t.always;
+
+	std::vector<uint32_t> yuv(paletteSize);
+	for (uint32_t i = 0; i < paletteSize; i++)
+	{
+		uint32_t color = palette[i];
+		if (rgbaPalette_)
+			color = (color & 0xFF00FF00) | ((color >> 16) & 0xFF) | ((color & 0xFF) << 16);
+		yuv[i] = ARGBtoAYUV(color);
+	}
+
+	const uint32_t words = (paletteSize + 63) / 64;
+	diffTable_.assign(static_cast<size_t>(paletteSize) * words, 0);
+	for (uint32_t a = 0; a < paletteSize; a++)
+	{
+		for (uint32_t b = 0; b < paletteSize; b++)
+		{
+			if (palette[a] != palette[b] && differs(yuv[a], yuv[b], t))
+				diffTable_[a * words + (b >> 6)] |= uint64_t(1) << (b & 63);
+		}
+	}
+}
+
+void HQx::prepareIndexed(
+	const uint16_t *indices,
+	const uint32_t *palette,
+	uint32_t paletteSize,
+	uint32_t width,
+	uint32_t height,
+	uint32_t trY,
+	uint32_t trU,
+	uint32_t trV,
+	uint32_t trA,
+	bool wrapX,
+	bool wrapY ) const
+{
+	const size_t pixels = static_cast<size_t>(width) * height;
+	patterns_.resize(pixels);
+	argb_.resize(pixels);
+	ids_.resize(pixels);
+
+	updateDiffTable(palette, paletteSize, trY, trU, trV, trA);
+
+	frame_.indices = indices;
+	frame_.indexed = true;
+	frame_.paletteSize = paletteSize;
+	frame_.width = width;
+	frame_.height = height;
+	frame_.wrapX = wrapX;
+	frame_.wrapY = wrapY;
+	frame_.always = diffAlways_;
+
+	// Expand to ARGB for the blends, and give every value in the frame a
+	// dense id; with more than 64 of them (only possible with mid-frame
+	// emphasis or greyscale changes) the full table is used instead
+	remap_.assign(paletteSize, -1);
+	uint32_t used[MAX_DENSE_COLORS];
+	uint32_t count = 0;
+	frame_.dense = true;
+	for (size_t i = 0; i < pixels; i++)
+	{
+		const uint16_t index = indices[i];
+		argb_[i] = palette[index];
+		if (!frame_.dense) continue;
+
+		int32_t id = remap_[index];
+		if (id < 0)
+		{
+			if (count == MAX_DENSE_COLORS)
+			{
+				frame_.dense = false;
+				continue;
+			}
+			id = remap_[index] = static_cast<int32_t>(count);
+			used[count++] = index;
+		}
+		ids_[i] = static_cast<uint8_t>(id);
+	}
+	frame_.image = argb_.data();
+
+	if (frame_.dense)
+	{
+		const DiffTable table = { diffTable_.data(), (paletteSize + 63) / 64, diffAlways_ };
+		for (uint32_t a = 0; a < count; a++)
+		{
+			uint64_t mask = 0;
+			for (uint32_t b = 0; b < count; b++)
+			{
+				if (table.get(used[a], used[b])) mask |= uint64_t(1) << b;
+			}
+			frame_.masks[a] = mask;
+		}
+	}
+}
+
+void HQx::computePatternRows(uint32_t rowBegin, uint32_t rowEnd) const
+{
+	const Frame& f = frame_;
+	const uint32_t width = f.width;
+	const uint32_t height = f.height;
+
+	if (f.indexed && f.dense)
+	{
+		patternRows(ids_.data(), width, height, f.wrapX, f.wrapY, rowBegin, rowEnd, patterns_.data(),
+			[&](const uint8_t *const rows[3], uint32_t left, uint32_t col, uint32_t right) {
+				return densePattern(rows, left, col, right, f.masks, f.always);
+			});
+		return;
+	}
+
+	if (f.indexed)
+	{
+		const DiffTable table = { diffTable_.data(), (f.paletteSize + 63) / 64, f.always };
+		patternRows(f.indices, width, height, f.wrapX, f.wrapY, rowBegin, rowEnd, patterns_.data(),
+			[&](const uint16_t *const rows[3], uint32_t left, uint32_t col, uint32_t right) {
+				return indexedPattern(rows, left, col, right, table);
+			});
+		return;
+	}
+
+	const Thresholds t = { f.thresholds, f.always };
+	const RowKernel rowKernel = kernel().row;
+
+	// Edge columns: wrap around, or repeat the edge pixel like the kernels do
+	const uint32_t firstLeft = f.wrapX ? width - 1 : 0;
+	const uint32_t lastRight = f.wrapX ? 0 : width - 1;
+
+	for (uint32_t row = rowBegin; row < rowEnd; row++)
+	{
+		const uint32_t above = row > 0 ? row - 1 : (f.wrapY ? height - 1 : row);
+		const uint32_t below = row < height - 1 ? row + 1 : (f.wrapY ? 0 : row);
+		const uint32_t lines[3] = { above, row, below };
+
+		Rows rows;
+		for (int r = 0; r < 3; r++)
+		{
+			rows.rgb[r] = f.image + static_cast<size_t>(lines[r]) * width;
+			rows.yuv[r] = yuv_.data() + static_cast<size_t>(lines[r]) * width;
+		}
+		uint16_t *out = patterns_.data() + static_cast<size_t>(row) * width;
+
+		if (width == 1)
+		{
+			out[0] = pixelPattern(rows, firstLeft, 0, lastRight, t);
+			continue;
+		}
+
+		out[0] = pixelPattern(rows, firstLeft, 0, 1, t);
+		const uint32_t done = rowKernel(rows, out, 1, width - 1, t);
+		patternRowScalar(rows, out, done, width - 1, t);
+		out[width - 1] = pixelPattern(rows, width - 2, width - 1, lastRight, t);
+	}
+}
+
+void HQx::scale(uint32_t *output) const
+{
+	const uint32_t width = frame_.width;
+	const uint32_t height = frame_.height;
+	if (width == 0 || height == 0) return;
+
+	// One band per thread; a band reads the source row above and below it
+	// but only writes its own patterns and output rows
+	const unsigned bands = std::min<unsigned>(getThreadCount(), height);
+	auto band = [&](unsigned i) {
+		const uint32_t rowBegin = static_cast<uint32_t>(static_cast<uint64_t>(height) * i / bands);
+		const uint32_t rowEnd = static_cast<uint32_t>(static_cast<uint64_t>(height) * (i + 1) / bands);
+		computePatternRows(rowBegin, rowEnd);
+		blendRows(frame_.image, patterns_.data(), width, height, output, frame_.wrapX, frame_.wrapY, rowBegin, rowEnd);
+	};
+
+	if (pool_ && bands > 1)
+		pool_->run(bands, band);
+	else
+		band(0);
+}
@@ -19,6 +19,10 @@
 
 
 #include <stdint.h>
+#include <memory>
+#include <vector>
+
+class WorkerPool;
 
 
 #define MASK_RB   0x00FF00FF
@@ -158,6 +162,24 @@ class HQx
 			bool wrapX = false,
 			bool wrapY = false ) const = 0;
 
+		/**
+		 * @brief Scales a palette-indexed image; the output is the same as
+		 * resize() on the expanded ARGB image (see prepareIndexed).
+		 */
+		virtual uint32_t *resizeIndexed(
+			const uint16_t *indices,
+			const uint32_t *palette,
+			uint32_t paletteSize,
+			uint32_t width,
+			uint32_t height,
+			uint32_t *output,
+			uint32_t trY = 0x30,
+			uint32_t trU = 0x07,
+			uint32_t trV = 0x06,
+			uint32_t trA = 0x50,
+			bool wrapX = false,
+			bool wrapY = false ) const = 0;
+
 		static bool isDifferent(
 			uint32_t yuv1,
 			uint32_t yuv2,
@@ -165,6 +187,179 @@ class HQx
 			uint32_t trU,
 			uint32_t trV,
 			uint32_t trA );
+
+		/**
+		 * @brief Returns the name of the pattern kernel resize() uses
+		 * ("avx2", "sse4.1" or "scalar"): the fastest this CPU supports
+		 * unless setKernel() picked another.
+		 */
+		static const char *getKernelName();
+
+		/**
+		 * @brief Returns the pattern kernels this CPU can run, fastest first;
+		 * "scalar" is always there.
+		 */
+		static std::vector<const char *> getKernelNames();
+
+		/**
+		 * @brief Forces the pattern kernel resize() uses, e.g. to check the
+		 * SIMD ones against "scalar". Returns false if this CPU can't run it.
+		 * Affects every instance; must not be called while a resize is
+		 * running.
+		 */
+		static bool setKernel(
+			const char *name );
+
+		/**
+		 * @brief Sets the number of threads a resize is split across,
+		 * including the calling one. Extra threads are kept in a persistent
+		 * pool; 1 (the default) scales on the calling thread only. Must not
+		 * be called while a resize is running.
+		 */
+		void setThreadCount(
+			unsigned threads );
+
+		unsigned getThreadCount() const;
+
+		/**
+		 * @brief Takes resizeIndexed() palettes as 0xAABBGGRR (R, G, B, A
+		 * bytes in memory) and so writes the output in that order too. The
+		 * neighbour tests still see the colours as ARGB, and the blends treat
+		 * red and blue alike, so the result is the ARGB one with red and blue
+		 * swapped.
+		 */
+		void setRgbaPalette(
+			bool rgba );
+
+		bool getRgbaPalette() const;
+
+	protected:
+		// Bits 8-11 of a pattern entry: the neighbour pair tests the cases
+		// use to choose between blends, i.e. isDifferent(w[a], w[b])
+		static const uint16_t DIFF_1_5 = 0x100;
+		static const uint16_t DIFF_3_1 = 0x200;
+		static const uint16_t DIFF_5_7 = 0x400;
+		static const uint16_t DIFF_7_3 = 0x800;
+
+		/**
+		 * @brief Prepares an ARGB image for scale().
+		 *
+		 * Every pixel is converted to YUV once. The neighbour comparisons then
+		 * run 4 or 8 pixels at a time when the CPU supports SSE4.1 or AVX2,
+		 * with the same result as isDifferent() with these (already shifted)
+		 * thresholds.
+		 */
+		void prepare(
+			const uint32_t *image,
+			uint32_t width,
+			uint32_t height,
+			uint32_t trY,
+			uint32_t trU,
+			uint32_t trV,
+			uint32_t trA,
+			bool wrapX,
+			bool wrapY ) const;
+
+		/**
+		 * @brief Prepares a palette-indexed image for scale().
+		 *
+		 * Every comparison becomes a lookup in a paletteSize x paletteSize
+		 * bit table of "different" flags. The table is built from the palette
+		 * colours and only rebuilt when the thresholds or the palette change,
+		 * so no pixel is converted to YUV. A frame using at most 64 of the
+		 * indices is renumbered first, which shrinks each table row to one
+		 * 64-bit mask. Indices must be below paletteSize.
+		 */
+		void prepareIndexed(
+			const uint16_t *indices,
+			const uint32_t *palette,
+			uint32_t paletteSize,
+			uint32_t width,
+			uint32_t height,
+			uint32_t trY,
+			uint32_t trU,
+			uint32_t trV,
+			uint32_t trA,
+			bool wrapX,
+			bool wrapY ) const;
+
+		/**
+		 * @brief Scales the prepared image into output.
+		 *
+		 * The image is split into one horizontal band per thread. Each band
+		 * computes the neighbour pattern of its pixels (bits 0-7 the classic
+		 * pattern, bits 8-11 the DIFF_* pair tests) and hands its rows to
+		 * blendRows(). The source and the row above and below each band are
+		 * only read, so bands need no copies and no locking.
+		 */
+		void scale(
+			uint32_t *output ) const;
+
+		/**
+		 * @brief Writes the output for source rows [rowBegin, rowEnd).
+		 *
+		 * image and patterns cover the whole source. Called concurrently for
+		 * disjoint bands of the same image.
+		 */
+		virtual void blendRows(
+			const uint32_t *image,
+			const uint16_t *patterns,
+			uint32_t width,
+			uint32_t height,
+			uint32_t *output,
+			bool wrapX,
+			bool wrapY,
+			uint32_t rowBegin,
+			uint32_t rowEnd ) const = 0;
+
+	private:
+		void updateDiffTable(
+			const uint32_t *palette,
+			uint32_t paletteSize,
+			uint32_t trY,
+			uint32_t trU,
+			uint32_t trV,
+			uint32_t trA ) const;
+
+		void computePatternRows(
+			uint32_t rowBegin,
+			uint32_t rowEnd ) const;
+
+		// The image being scaled, set up by prepare()/prepareIndexed()
+		struct Frame
+		{
+			const uint32_t *image;      // ARGB, expanded for indexed images
+			const uint16_t *indices;
+			bool indexed;
+			bool dense;                 // indexed, at most 64 values: masks[]
+			uint32_t paletteSize;
+			uint32_t width;
+			uint32_t height;
+			bool wrapX;
+			bool wrapY;
+			uint32_t thresholds;        // per-byte AYUV limits
+			bool always;                // a negative threshold: all differ
+			uint64_t masks[64];
+		};
+
+		mutable Frame frame_;
+		mutable std::vector<uint32_t> yuv_;
+		mutable std::vector<uint16_t> patterns_;
+		mutable std::vector<uint32_t> argb_;
+		mutable std::vector<uint8_t> ids_;
+		mutable std::vector<int32_t> remap_;
+
+		// Palette difference table: row a, bit b is set when colours a and b
+		// are unequal and isDifferent(). Keyed by the palette and thresholds.
+		mutable std::vector<uint64_t> diffTable_;
+		mutable std::vector<uint32_t> diffPalette_;
+		mutable uint32_t diffThresholds_[4];
+		mutable bool diffAlways_;
+		mutable bool diffRgba_;
+
+		bool rgbaPalette_;
+
+		std::unique_ptr<WorkerPool> pool_;
 };
 
 
@@ -1,4 +1,5 @@
 #include "input.h"
+#include "savestate.h"
 
 Input::Input()
     : controller_state(0)
@@ -7,28 +8,6 @@ Input::Input()
 {
 }
 
-void Input::updateFromKeyboard()
-{
-    controller_state = 0;
-    
-    // Map keyboard to NES controller
-    // Arrow keys for D-pad
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Up))    controller_state |= BUTTON_UP;
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Down))  controller_state |= BUTTON_DOWN;
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Left))  controller_state |= BUTTON_LEFT;
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Right)) controller_state |= BUTTON_RIGHT;
-    
-    // Z/J = A, X/K = B (multiple bindings to avoid ghosting)
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Z) ||
-        sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Space)) controller_state |= BUTTON_A;
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::X) ||
-        sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LShift)) controller_state |= BUTTON_B;
-    
-    // Enter = Start, RShift = Select
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Enter)) controller_state |= BUTTON_START;
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RShift)) controller_state |= BUTTON_SELECT;
-}
-
 void Input::strobe()
 {
     // Latch current controller state
@@ -52,3 +31,16 @@ u8 Input::read()
     
     return value | 0x40;  // Open bus bits
 }
+
+u8 Input::peek() const
+{
+    // read() returns 1 once all eight bits have been shifted out
+    u8 value = (shift_count >= 8) ? 0x01 : (controller_latch & 0x01);
+    return value | 0x40;
+}
+
+void Input::serialize(StateStream& s)
+{
+    s.io(controller_latch);
+    s.io(shift_count);
+}
@@ -2,7 +2,8 @@
 #define INPUT_H
 
 #include "types.h"
-#include <SFML/Window.hpp>
+
+class StateStream;
 
 class Input {
 public:
@@ -20,14 +21,22 @@ public:
         BUTTON_RIGHT  = 0x80
     };
     
-    // Update controller state from keyboard
-    void updateFromKeyboard();
+    // Set current button states (bitmask of Button values).
+    // The frontend decides where they come from (keyboard, replay, none).
+    void setState(u8 state) { controller_state = state; }
+    u8 getState() const { return controller_state; }
     
     // Controller strobe (called when CPU writes to $4016)
     void strobe();
     
     // Read controller state (called when CPU reads $4016)
     u8 read();
+
+    // The value the next read() returns, without shifting (for the debugger)
+    u8 peek() const;
+
+    // Save-state support (shift register position, not live button state)
+    void serialize(StateStream& s);
     
 private:
     u8 controller_state;  // Current button states
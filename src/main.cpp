@@ -3,16 +3,25 @@
 #include "bus.h"
 #include "cartridge.h"
 #include "display.h"
+#include "emu_thread.h"
 #include "input.h"
 #include "sound.h"
 #include "web_server.h"
 #include "gui.h"
+#include "profiler.h"
+#include "util.h"
 
 void printUsage(const char* program)
 {
     std::cout << "VNES - Minimal NES Emulator" << std::endl;
     std::cout << "Usage: " << program << " [options] [rom.nes]" << std::endl;
     std::cout << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --scaler-threads N  Split HQ2x scaling across N threads (default: half the cores, max 4)" << std::endl;
+    std::cout << "  --run-ahead N       Emulate N frames (1-4) ahead to cut input lag (default: off)" << std::endl;
+    std::cout << "  --turbo-speed N     Turbo speed multiplier, 2-16 or 0 for unlimited (default: 4)" << std::endl;
+    std::cout << "  -h, --help          Show this help" << std::endl;
+    std::cout << std::endl;
     std::cout << "If no ROM is specified, use File->Load ROM in the GUI (press ESC)" << std::endl;
 }
 
@@ -20,36 +29,81 @@ int main(int argc, char* argv[])
 {
     // Parse arguments
     const char* rom_file = nullptr;
+    int scaler_threads = 0;     // 0 = Display default
+    int run_ahead = 0;
+    int turbo_speed = -1;       // -1 = Gui default
 
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
             printUsage(argv[0]);
             return 0;
         }
-        rom_file = argv[i];
+        else if (strcmp(argv[i], "--scaler-threads") == 0 && i + 1 < argc) {
+            auto parsed = vnes::util::parseInteger(argv[++i]);
+            if (!parsed || *parsed == 0) {
+                std::cerr << "Invalid scaler thread count: " << argv[i] << std::endl;
+                return 1;
+            }
+            scaler_threads = static_cast<int>(std::min<u64>(*parsed, Gui::MAX_SCALER_THREADS));
+        }
+        else if (strcmp(argv[i], "--run-ahead") == 0 && i + 1 < argc) {
+            auto parsed = vnes::util::parseInteger(argv[++i]);
+            if (!parsed || *parsed > Gui::MAX_RUN_AHEAD_FRAMES) {
+                std::cerr << "Invalid run-ahead frame count (expected 0-4): " << argv[i] << std::endl;
+                return 1;
+            }
+            run_ahead = static_cast<int>(*parsed);
+        }
+        else if (strcmp(argv[i], "--turbo-speed") == 0 && i + 1 < argc) {
+            auto parsed = vnes::util::parseInteger(argv[++i]);
+            if (!parsed || *parsed == 1 || *parsed > Gui::MAX_TURBO_SPEED) {
+                std::cerr << "Invalid turbo speed (expected 2-16, or 0 for unlimited): " << argv[i] << std::endl;
+                return 1;
+            }
+            turbo_speed = static_cast<int>(*parsed);
+        }
+        else {
+            rom_file = argv[i];
+        }
     }
 
     // Create system bus
     Bus bus;
-    bool romLoaded = false;
+
+    // Start web server
+    WebServer web;
+    web.start(18080);
+
+    // Audio output device
+    Sound sound;
+    sound.start();
+    bus.apu.setAudioSink(&sound);
+
+    Display display("VNES - NES Emulator", bus);
+    sf::RenderWindow& window = display.getWindow();
+    if (scaler_threads > 0) {
+        display.setScalerThreads(scaler_threads);
+    }
+    display.getGui().setRunAheadFrames(run_ahead);
+    if (turbo_speed >= 0) {
+        display.getGui().setTurboSpeed(turbo_speed);
+    }
+
+    // The machine runs on its own thread from here on; this thread handles
+    // events, the GUI and presentation
+    EmuThread emu(bus, display);
 
     // Load ROM if provided
     if (rom_file) {
-        if (!bus.loadCartridge(rom_file)) {
+        if (!emu.loadRom(rom_file)) {
             std::cerr << "Failed to load ROM: " << rom_file << std::endl;
             std::cerr << "Starting without ROM - use GUI to load" << std::endl;
         } else {
-            romLoaded = true;
-            bus.reset();
             std::cout << "\nSystem initialized!" << std::endl;
             std::cout << "CPU PC: 0x" << std::hex << bus.cpu.getPC() << std::dec << std::endl;
         }
     }
 
-    // Start web server
-    WebServer web;
-    web.start(18080);
-
     // Normal execution with display
     std::cout << "\nStarting emulation..." << std::endl;
     std::cout << "Controls:" << std::endl;
@@ -58,21 +112,18 @@ int main(int argc, char* argv[])
     std::cout << "  B Button: X or K" << std::endl;
     std::cout << "  Start: Enter or Space" << std::endl;
     std::cout << "  Select: Shift" << std::endl;
+    std::cout << "  Turbo: hold Tab" << std::endl;
     std::cout << "  (Multiple key bindings provided to avoid keyboard ghosting)" << std::endl;
     std::cout << "Press ESC to toggle GUI menu" << std::endl;
 
-    Display display("VNES - NES Emulator", bus);
-    sf::RenderWindow& window = display.getWindow();
-
-    // Emulation state
-    bool paused = !romLoaded;  // Start paused if no ROM
-
     // If no ROM loaded, show the GUI menu
-    if (!romLoaded) {
+    if (!emu.isRomLoaded()) {
         display.getGui().toggleMenu();
         display.getGui().setPaused(true);
     }
 
+    emu.start();
+
     while (display.isOpen()) {
         // Process events (handled by Display, which forwards to GUI)
         display.pollEvents();
@@ -82,48 +133,42 @@ int main(int argc, char* argv[])
         switch (action.type) {
             case GuiAction::LoadRom:
                 std::cout << "Loading ROM: " << action.romPath << std::endl;
-                if (bus.loadCartridge(action.romPath)) {
-                    bus.reset();
-                    romLoaded = true;
-                    paused = false;
+                if (emu.loadRom(action.romPath)) {
                     display.getGui().setPaused(false);
                     std::cout << "ROM loaded successfully!" << std::endl;
-                    std::cout << "CPU PC: 0x" << std::hex << bus.cpu.getPC() << std::dec << std::endl;
                 } else {
                     std::cerr << "Failed to load ROM: " << action.romPath << std::endl;
                 }
                 break;
 
             case GuiAction::Reset:
-                if (romLoaded) {
-                    bus.reset();
+                if (emu.isRomLoaded()) {
+                    emu.reset();
                     std::cout << "System reset!" << std::endl;
                 }
                 break;
 
             case GuiAction::Pause:
-                paused = true;
-                break;
-
             case GuiAction::Resume:
-                paused = false;
+                // The GUI holds the pause state, synced below
                 break;
 
             case GuiAction::Step:
-                if (romLoaded && paused) {
-                    bus.clock();
+                if (display.getGui().isPaused()) {
+                    emu.step();
                 }
                 break;
 
             case GuiAction::StepFrame:
-                if (romLoaded && paused) {
-                    while (!bus.ppu.isFrameComplete()) {
-                        bus.clock();
-                    }
-                    bus.ppu.clearFrameComplete();
+                if (display.getGui().isPaused()) {
+                    emu.stepFrame();
                 }
                 break;
 
+            case GuiAction::Rewind:
+                emu.rewind(action.frames);
+                break;
+
             case GuiAction::Quit:
                 window.close();
                 break;
@@ -133,33 +178,35 @@ int main(int argc, char* argv[])
                 break;
         }
 
-        // Sync pause state with GUI
-        paused = display.getGui().isPaused();
-
-        // Update input state
-        bus.updateInput();
-
-        // Run one frame (only if ROM loaded and not paused)
-        if (romLoaded && !paused) {
-            while (!bus.ppu.isFrameComplete()) {
-                bus.clock();
-            }
-            bus.ppu.clearFrameComplete();
-
-            // Notify cartridge that frame is complete (for SRAM auto-save)
-            bus.cartridge.signalFrameComplete();
+        // Input and settings for the next emulated frame
+        emu.setPaused(display.getGui().isPaused());
+        emu.setController(display.readController());
+        emu.setRewindHeld(display.isRewindHeld());
+        emu.setRunAheadFrames(display.getGui().getRunAheadFrames());
+
+        const bool turbo = display.getGui().isTurboEnabled() || display.isTurboHeld();
+        emu.setSpeed(turbo ? display.getGui().getTurboSpeed() : 1);
+        display.getGui().setTurboActive(turbo);
+
+        // Pacing and audio statistics for Debug -> Performance
+        PacingStats pacing;
+        if (emu.takePacingStats(pacing)) {
+            pacing.audio_buffered = sound.getBufferedSamples();
+            pacing.audio_target = Sound::TARGET_FILL;
+            pacing.audio_rate_scale = sound.getRateScale();
+            display.getGui().setPacingStats(pacing);
         }
 
-        // Update display
-        if (romLoaded) {
-            display.update(bus.ppu.getFramebuffer());
+        // Upload the newest scaled frame
+        if (emu.isRomLoaded()) {
+            display.update();
         }
 
         // Handle Game Genie input from GUI (forwarded by Display)
         std::string ggcode;
         if (display.getGameGenieCode(ggcode)) {
-            if (romLoaded) {
-                if (!bus.cartridge.addGGCode(ggcode)) {
+            if (emu.isRomLoaded()) {
+                if (!emu.addGameGenieCode(ggcode)) {
                     std::cerr << "Failed to add Game Genie code: " << ggcode << std::endl;
                 }
                 else {
@@ -169,12 +216,30 @@ int main(int argc, char* argv[])
                 std::cerr << "Cannot add Game Genie code: no ROM loaded" << std::endl;
             }
         }
+
+        // Debugger console commands read and change the machine
+        std::string command;
+        while (display.getGui().getConsole().pollCommand(command)) {
+            emu.runCommand([&] { display.getGui().getConsole().executeCommand(command); });
+        }
+
+        // The debug windows show the newest snapshot the emulation thread
+        // published, so building them never waits for the bus lock
+        emu.setMemoryView(display.getGui().getMemoryView());
+        display.getGui().setDebugSnapshot(emu.takeDebugSnapshot());
+        display.buildGui();
+
         // Present frame (display sprite + ImGui on top)
         display.present();
+
+        // Close this frame's profiler sample
+        VNES_PROFILE_FRAME();
     }
 
+    emu.stop();
+
     // Final SRAM flush on exit
-    if (romLoaded) {
+    if (emu.isRomLoaded()) {
         bus.cartridge.flushSRAM();
     }
     web.stop();
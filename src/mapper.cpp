@@ -4,6 +4,7 @@
 #include "mapper_002.h"
 #include "mapper_004.h"
 #include "mapper_009.h"
+#include "savestate.h"
 
 Mapper::Mapper(u8 mapperNumber)
     : mapperNum(mapperNumber)
@@ -11,6 +12,12 @@ Mapper::Mapper(u8 mapperNumber)
     , prgRom(nullptr)
     , chrRom(nullptr)
     , prgRam(nullptr)
+    , prgReadSlots{}
+    , prgWriteSlots{}
+    , prgMapChanged(true)
+    , chrBanks{}
+    , chrGeneration(0)
+    , mirroringChanged(true)
 {
 }
 
@@ -21,6 +28,59 @@ void Mapper::init(std::vector<u8>& prg, std::vector<u8>& chr,
     chrRom = &chr;
     prgRam = &ram;
     mirroring = initialMirroring;
+    mirroringChanged = true;
+
+    // Default map: PRG RAM at $6000, ROM mirrored across $8000-$FFFF
+    mapPrgRam(true, true);
+    for (int slot = 1; slot < PRG_SLOT_COUNT; slot++) {
+        mapPrgRom(slot, static_cast<u32>(slot - 1) * PRG_BANK_8K);
+    }
+
+    // Default CHR map: the first 8KB
+    for (int bank = 0; bank < CHR_BANK_COUNT; bank++) {
+        mapChr1k(bank, static_cast<u32>(bank) * CHR_BANK_1K);
+    }
+}
+
+void Mapper::mapPrgRom(int slot, u32 offset)
+{
+    if (prgRom->empty()) {
+        prgReadSlots[slot] = nullptr;
+    } else {
+        prgReadSlots[slot] = prgRom->data() + (offset % prgRom->size());
+    }
+    prgWriteSlots[slot] = nullptr;   // ROM writes go to the mapper registers
+    prgMapChanged = true;
+}
+
+void Mapper::mapChr1k(int bank, u32 offset)
+{
+    const u8* data = chrRom->empty() ? nullptr : chrRom->data() + (offset % chrRom->size());
+    if (chrBanks[bank] != data) {
+        chrBanks[bank] = data;
+        chrGeneration++;
+    }
+}
+
+void Mapper::setMirroring(Mirroring mode)
+{
+    if (mirroring == Mirroring::FOUR_SCREEN || mode == mirroring) return;
+
+    mirroring = mode;
+    mirroringChanged = true;
+}
+
+void Mapper::mapPrgRam(bool readable, bool writable)
+{
+    u8* ram = prgRam->empty() ? nullptr : prgRam->data();
+    prgReadSlots[0] = readable ? ram : nullptr;
+    prgWriteSlots[0] = writable ? ram : nullptr;
+    prgMapChanged = true;
+}
+
+void Mapper::serialize(StateStream& s)
+{
+    s.io(mirroring);
 }
 
 std::unique_ptr<Mapper> MapperFactory::create(u8 mapperNumber)
@@ -11,6 +11,7 @@
 
 // Forward declaration
 class Cartridge;
+class StateStream;
 
 // Mirroring modes
 enum class Mirroring {
@@ -30,6 +31,12 @@ static const u32 CHR_BANK_4K = 4096;    // 4KB
 static const u32 CHR_BANK_1K = 1024;    // 1KB
 static const u32 TRAINER_SIZE = 512;
 
+// CPU-side PRG map: $6000-$FFFF in 8KB slots (slot 0 = PRG RAM at $6000)
+static const int PRG_SLOT_COUNT = 5;
+
+// PPU-side CHR map: $0000-$1FFF in 1KB banks
+static const int CHR_BANK_COUNT = 8;
+
 /**
  * Base Mapper class - interface for all NES mappers
  * 
@@ -56,6 +63,9 @@ public:
     // Mirroring control - some mappers can change mirroring dynamically
     Mirroring getMirroring() const { return mirroring; }
 
+    // True (once) after the mirroring mode changed
+    bool takeMirroringChange() { bool changed = mirroringChanged; mirroringChanged = false; return changed; }
+
 	// IRQ handling - for mappers that support scanline-based IRQs (e.g. MMC3)
 	virtual bool irqPending() const { return false; }
 	virtual void clearIrq() {}
@@ -68,10 +78,42 @@ public:
     // Optional: scanline counter for mappers like MMC3
     virtual void scanline() {}
 
-    // Optional: PPU address notification for mappers like MMC2/MMC4
+    // Optional: PPU address notification for mappers like MMC2/MMC4. The
+    // PPU only calls it after pattern fetches when wantsPpuAddr() is true.
     virtual void notifyPpuAddr(u16 addr) { (void)addr; }
+    virtual bool wantsPpuAddr() const { return false; }
+
+    // Save-state hook: mappers with registers override this, call the base
+    // version first, then list their own fields (see savestate.h)
+    virtual void serialize(StateStream& s);
+
+    // Direct PRG pointers published for the bus page table. A null slot
+    // sends CPU accesses in that range through readPrg/writePrg instead.
+    const u8* getPrgReadSlot(int slot) const { return prgReadSlots[slot]; }
+    u8* getPrgWriteSlot(int slot) const { return prgWriteSlots[slot]; }
+
+    // True (once) after the published slots changed
+    bool takePrgMapChange() { bool changed = prgMapChanged; prgMapChanged = false; return changed; }
+
+    // Pattern table fetches read these 1KB bank pointers directly. The
+    // array lives as long as the mapper, so the PPU can keep the pointer.
+    const u8* const* getChrBanks() const { return chrBanks; }
+
+    // Bumped whenever a CHR bank pointer changes, so viewers can tell when
+    // the pattern tables they decoded are stale
+    u32 getChrGeneration() const { return chrGeneration; }
 
 protected:
+    // Point a slot at `offset` into PRG ROM (read-only) or set PRG RAM access
+    void mapPrgRom(int slot, u32 offset);
+    void mapPrgRam(bool readable, bool writable);
+
+    // Point a 1KB CHR bank at `offset` into CHR ROM/RAM
+    void mapChr1k(int bank, u32 offset);
+
+    // Mapper-controlled mirroring (ignored on hardwired four-screen boards)
+    void setMirroring(Mirroring mode);
+
     u8 mapperNum;
     Mirroring mirroring;
    
@@ -79,6 +121,14 @@ protected:
     std::vector<u8>* prgRom;
     std::vector<u8>* chrRom;
     std::vector<u8>* prgRam;
+
+private:
+    const u8* prgReadSlots[PRG_SLOT_COUNT];
+    u8* prgWriteSlots[PRG_SLOT_COUNT];
+    bool prgMapChanged;
+    const u8* chrBanks[CHR_BANK_COUNT];
+    u32 chrGeneration;
+    bool mirroringChanged;
 };
 
 /**
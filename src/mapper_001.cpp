@@ -1,4 +1,5 @@
 #include "mapper_001.h"
+#include "savestate.h"
 
 Mapper001::Mapper001()
     : Mapper(1)
@@ -33,6 +34,7 @@ void Mapper001::init(std::vector<u8>& prg, std::vector<u8>& chr,
     prgBankOffset[1] = static_cast<u32>(prgRom->size() - PRG_ROM_UNIT);
     chrBankOffset[0] = 0;
     chrBankOffset[1] = CHR_BANK_4K;
+    updatePrgMap();
 }
 
 u8 Mapper001::readPrg(u16 addr)
@@ -101,10 +103,10 @@ void Mapper001::writeRegister(u16 addr, u8 data)
 
             // Update mirroring based on bits 0-1
             switch (value & 0x03) {
-                case 0: mirroring = Mirroring::SINGLE_LOWER; break;
-                case 1: mirroring = Mirroring::SINGLE_UPPER; break;
-                case 2: mirroring = Mirroring::VERTICAL; break;
-                case 3: mirroring = Mirroring::HORIZONTAL; break;
+                case 0: setMirroring(Mirroring::SINGLE_LOWER); break;
+                case 1: setMirroring(Mirroring::SINGLE_UPPER); break;
+                case 2: setMirroring(Mirroring::VERTICAL); break;
+                case 3: setMirroring(Mirroring::HORIZONTAL); break;
             }
         }
         else if (addr < 0xC000) {
@@ -157,6 +159,7 @@ void Mapper001::updateBanks()
             prgBankOffset[1] = (prgBankCount - 1) * PRG_ROM_UNIT;
             break;
     }
+    updatePrgMap();
 
     // CHR ROM bank mode (bit 4 of control register)
     if (chrBankCount == 0) return;  // No CHR to bank
@@ -171,6 +174,25 @@ void Mapper001::updateBanks()
         chrBankOffset[0] = bank * CHR_BANK_4K;
         chrBankOffset[1] = (bank + 1) * CHR_BANK_4K;
     }
+    updateChrMap();
+}
+
+void Mapper001::updatePrgMap()
+{
+    // Each 16KB bank covers two 8KB slots
+    mapPrgRom(1, prgBankOffset[0]);
+    mapPrgRom(2, prgBankOffset[0] + PRG_BANK_8K);
+    mapPrgRom(3, prgBankOffset[1]);
+    mapPrgRom(4, prgBankOffset[1] + PRG_BANK_8K);
+}
+
+void Mapper001::updateChrMap()
+{
+    // Two 4KB banks of four 1KB pages each
+    for (int i = 0; i < 4; i++) {
+        mapChr1k(i, chrBankOffset[0] + i * CHR_BANK_1K);
+        mapChr1k(i + 4, chrBankOffset[1] + i * CHR_BANK_1K);
+    }
 }
 
 u8 Mapper001::readChr(u16 addr)
@@ -198,3 +220,21 @@ void Mapper001::writeChr(u16 addr, u8 data)
         (*chrRom)[mappedAddr] = data;
     }
 }
+
+void Mapper001::serialize(StateStream& s)
+{
+    Mapper::serialize(s);
+    s.io(shiftReg);
+    s.io(shiftCount);
+    s.io(ctrlReg);
+    s.io(chrBank0);
+    s.io(chrBank1);
+    s.io(prgBank);
+    s.io(prgBankOffset);
+    s.io(chrBankOffset);
+
+    if (s.isLoading()) {
+        updatePrgMap();
+        updateChrMap();
+    }
+}
@@ -39,9 +39,14 @@ public:
 
     const char* getName() const override { return "MMC1"; }
 
+    // Save-state support
+    void serialize(StateStream& s) override;
+
 private:
     void writeRegister(u16 addr, u8 data);
     void updateBanks();
+    void updatePrgMap();
+    void updateChrMap();
 
     // Shift register
     u8 shiftReg;
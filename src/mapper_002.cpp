@@ -1,4 +1,5 @@
 #include "mapper_002.h"
+#include "savestate.h"
 
 Mapper002::Mapper002()
     : Mapper(2)
@@ -17,6 +18,17 @@ void Mapper002::init(std::vector<u8>& prg, std::vector<u8>& chr,
 
     // Initialize bank offset
     prgBankOffset = 0;
+    updatePrgMap();
+}
+
+void Mapper002::updatePrgMap()
+{
+    // Switchable 16KB bank at $8000, last bank fixed at $C000
+    const u32 lastBankOffset = static_cast<u32>(prgRom->size() - PRG_ROM_UNIT);
+    mapPrgRom(1, prgBankOffset);
+    mapPrgRom(2, prgBankOffset + PRG_BANK_8K);
+    mapPrgRom(3, lastBankOffset);
+    mapPrgRom(4, lastBankOffset + PRG_BANK_8K);
 }
 
 u8 Mapper002::readPrg(u16 addr)
@@ -61,6 +73,7 @@ void Mapper002::writePrg(u16 addr, u8 data)
         prgBankSelect = data & 0x0F;  // 4 bits for bank selection
         u32 bankCount = static_cast<u32>(prgRom->size()) / PRG_ROM_UNIT;
         prgBankOffset = (prgBankSelect % bankCount) * PRG_ROM_UNIT;
+        updatePrgMap();
     }
 }
 
@@ -79,3 +92,14 @@ void Mapper002::writeChr(u16 addr, u8 data)
         (*chrRom)[addr % chrRom->size()] = data;
     }
 }
+
+void Mapper002::serialize(StateStream& s)
+{
+    Mapper::serialize(s);
+    s.io(prgBankSelect);
+    s.io(prgBankOffset);
+
+    if (s.isLoading()) {
+        updatePrgMap();
+    }
+}
@@ -42,7 +42,12 @@ public:
 
     const char* getName() const override { return "UxROM"; }
 
+    // Save-state support
+    void serialize(StateStream& s) override;
+
 private:
+    void updatePrgMap();
+
     // PRG bank register
     u8 prgBankSelect;
 
@@ -1,4 +1,5 @@
 #include "mapper_004.h"
+#include "savestate.h"
 
 Mapper004::Mapper004()
     : Mapper(4)
@@ -65,6 +66,10 @@ void Mapper004::updatePrgBanks()
         prgBankOffset[2] = (secondToLast % prgBankCount) * PRG_BANK_8K;
         prgBankOffset[3] = (lastBank % prgBankCount) * PRG_BANK_8K;
     }
+
+    for (int i = 0; i < 4; i++) {
+        mapPrgRom(i + 1, prgBankOffset[i]);
+    }
 }
 
 void Mapper004::updateChrBanks()
@@ -103,6 +108,10 @@ void Mapper004::updateChrBanks()
         chrBankOffset[6] = (bankRegisters[4] % chrBankCount) * CHR_BANK_1K;
         chrBankOffset[7] = (bankRegisters[5] % chrBankCount) * CHR_BANK_1K;
     }
+
+    for (int i = 0; i < 8; i++) {
+        mapChr1k(i, chrBankOffset[i]);
+    }
 }
 
 u8 Mapper004::readPrg(u16 addr)
@@ -163,11 +172,12 @@ void Mapper004::writePrg(u16 addr, u8 data)
             // $A000-$BFFF
             if (isEven) {
                 // Mirroring ($A000, $A002, etc.)
-                mirroring = (data & 0x01) ? Mirroring::HORIZONTAL : Mirroring::VERTICAL;
+                setMirroring((data & 0x01) ? Mirroring::HORIZONTAL : Mirroring::VERTICAL);
             } else {
                 // PRG RAM protect ($A001, $A003, etc.)
                 prgRamWriteProtect = (data & 0x40) != 0;
                 prgRamEnable = (data & 0x80) != 0;
+                mapPrgRam(prgRamEnable, prgRamEnable && !prgRamWriteProtect);
             }
         }
         else if (addr < 0xE000) {
@@ -230,3 +240,25 @@ void Mapper004::writeChr(u16 addr, u8 data)
     u32 mappedAddr = (chrBankOffset[bank] + offset) % chrRom->size();
     (*chrRom)[mappedAddr] = data;
 }
+
+void Mapper004::serialize(StateStream& s)
+{
+    Mapper::serialize(s);
+    s.io(bankSelect);
+    s.io(bankRegisters);
+    s.io(prgRamEnable);
+    s.io(prgRamWriteProtect);
+    s.io(irqLatch);
+    s.io(irqCounter);
+    s.io(irqReload);
+    s.io(irqEnabled);
+    s.io(irqPendingFlag);
+    s.io(prgBankOffset);
+    s.io(chrBankOffset);
+
+    if (s.isLoading()) {
+        updatePrgBanks();
+        updateChrBanks();
+        mapPrgRam(prgRamEnable, prgRamEnable && !prgRamWriteProtect);
+    }
+}
@@ -56,6 +56,9 @@ public:
 
     const char* getName() const override { return "MMC3"; }
 
+    // Save-state support
+    void serialize(StateStream& s) override;
+
     // IRQ status
     bool irqPending() const { return irqPendingFlag; }
     void clearIrq() { irqPendingFlag = false; }
@@ -1,4 +1,5 @@
 #include "mapper_009.h"
+#include "savestate.h"
 
 Mapper009::Mapper009()
     : Mapper(9)
@@ -31,6 +32,7 @@ void Mapper009::init(std::vector<u8>& prg, std::vector<u8>& chr,
 
     // Initialize PRG bank offset
     prgBankOffset = 0;
+    updatePrgMap();
 
     // Initialize CHR banks
     updateChrBanks();
@@ -93,6 +95,7 @@ void Mapper009::writePrg(u16 addr, u8 data)
         prgBankSelect = data & 0x0F;
         u32 bankCount = static_cast<u32>(prgRom->size() / PRG_BANK_8K);
         prgBankOffset = (prgBankSelect % bankCount) * PRG_BANK_8K;
+        updatePrgMap();
     }
     else if (addr >= 0xB000 && addr < 0xC000) {
         // $B000-$BFFF: CHR bank 0 select ($FD latch)
@@ -116,10 +119,20 @@ void Mapper009::writePrg(u16 addr, u8 data)
     }
     else if (addr >= 0xF000) {
         // $F000-$FFFF: Mirroring control
-        mirroring = (data & 0x01) ? Mirroring::HORIZONTAL : Mirroring::VERTICAL;
+        setMirroring((data & 0x01) ? Mirroring::HORIZONTAL : Mirroring::VERTICAL);
     }
 }
 
+void Mapper009::updatePrgMap()
+{
+    // Switchable 8KB bank at $8000, the last three banks fixed above it
+    const u32 bankCount = static_cast<u32>(prgRom->size() / PRG_BANK_8K);
+    mapPrgRom(1, prgBankOffset);
+    mapPrgRom(2, (bankCount - 3) * PRG_BANK_8K);
+    mapPrgRom(3, (bankCount - 2) * PRG_BANK_8K);
+    mapPrgRom(4, (bankCount - 1) * PRG_BANK_8K);
+}
+
 void Mapper009::updateChrBanks()
 {
     if (!chrRom || chrRom->empty()) return;
@@ -134,6 +147,11 @@ void Mapper009::updateChrBanks()
     // Select CHR bank 1 based on latch 1
     u8 bank1 = latch1 ? chrBank1FE : chrBank1FD;
     chrBankOffset[1] = (bank1 % chrBankCount) * CHR_BANK_4K;
+
+    for (int i = 0; i < 4; i++) {
+        mapChr1k(i, chrBankOffset[0] + i * CHR_BANK_1K);
+        mapChr1k(i + 4, chrBankOffset[1] + i * CHR_BANK_1K);
+    }
 }
 
 u8 Mapper009::readChr(u16 addr)
@@ -145,38 +163,39 @@ u8 Mapper009::readChr(u16 addr)
     if (addr < 0x1000) {
         // CHR bank 0: $0000-$0FFF
         data = (*chrRom)[(chrBankOffset[0] + addr) % chrRom->size()];
-
-        // Check for latch trigger tiles
-        // The latch changes AFTER the data is read
-        u16 tileAddr = addr & 0x0FF8;  // Tile address (ignore fine Y)
-        if (tileAddr == 0x0FD8) {
-            latch0 = false;  // $FD tile
-            updateChrBanks();
-        }
-        else if (tileAddr == 0x0FE8) {
-            latch0 = true;   // $FE tile
-            updateChrBanks();
-        }
     }
     else {
         // CHR bank 1: $1000-$1FFF
         data = (*chrRom)[(chrBankOffset[1] + (addr - 0x1000)) % chrRom->size()];
-
-        // Check for latch trigger tiles
-        u16 tileAddr = addr & 0x0FF8;
-        if (tileAddr == 0x1FD8) {
-            latch1 = false;  // $FD tile
-            updateChrBanks();
-        }
-        else if (tileAddr == 0x1FE8) {
-            latch1 = true;   // $FE tile
-            updateChrBanks();
-        }
     }
 
+    // The latch changes AFTER the data is read
+    notifyPpuAddr(addr);
     return data;
 }
 
+void Mapper009::notifyPpuAddr(u16 addr)
+{
+    // Check for latch trigger tiles
+    u16 tileAddr = addr & 0x1FF8;  // Tile address (ignore fine Y)
+    if (tileAddr == 0x0FD8) {
+        latch0 = false;  // $FD tile
+        updateChrBanks();
+    }
+    else if (tileAddr == 0x0FE8) {
+        latch0 = true;   // $FE tile
+        updateChrBanks();
+    }
+    else if (tileAddr == 0x1FD8) {
+        latch1 = false;  // $FD tile
+        updateChrBanks();
+    }
+    else if (tileAddr == 0x1FE8) {
+        latch1 = true;   // $FE tile
+        updateChrBanks();
+    }
+}
+
 void Mapper009::writeChr(u16 addr, u8 data)
 {
     // MMC2 uses CHR ROM, which is not writable
@@ -184,3 +203,22 @@ void Mapper009::writeChr(u16 addr, u8 data)
     (void)addr;
     (void)data;
 }
+
+void Mapper009::serialize(StateStream& s)
+{
+    Mapper::serialize(s);
+    s.io(prgBankSelect);
+    s.io(chrBank0FD);
+    s.io(chrBank0FE);
+    s.io(chrBank1FD);
+    s.io(chrBank1FE);
+    s.io(latch0);
+    s.io(latch1);
+    s.io(prgBankOffset);
+    s.io(chrBankOffset);
+
+    if (s.isLoading()) {
+        updatePrgMap();
+        updateChrBanks();
+    }
+}
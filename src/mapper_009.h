@@ -52,10 +52,18 @@ public:
     u8 readChr(u16 addr) override;
     void writeChr(u16 addr, u8 data) override;
 
+    // Pattern fetches of tiles $FD/$FE flip the CHR latches
+    void notifyPpuAddr(u16 addr) override;
+    bool wantsPpuAddr() const override { return true; }
+
     const char* getName() const override { return "MMC2"; }
 
+    // Save-state support
+    void serialize(StateStream& s) override;
+
 private:
     void updateChrBanks();
+    void updatePrgMap();
 
     // PRG bank register
     u8 prgBankSelect;
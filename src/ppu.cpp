@@ -2,11 +2,18 @@
 #include "bus.h"
 #include "cartridge.h"
 #include "disasm.h"
+#include "profiler.h"
+#include "savestate.h"
+#include <array>
+#include <cstring>
 
 using namespace vnes::disasm;
 
 PPU::PPU(Bus& b, Cartridge& c)
     : bus(b), cart(c)
+    , chr_banks(nullptr), chr_notify(nullptr)
+    , nt_pages{}
+    , nametable_generation(0), palette_generation(0)
     , ctrl(0), mask(0), status(0), oam_addr(0)
     , v(0), t(0), fine_x(0), w(false)
     , data_buffer(0)
@@ -17,9 +24,11 @@ PPU::PPU(Bus& b, Cartridge& c)
     , at_shifter_lo(0), at_shifter_hi(0)
     , at_latch_lo(0), at_latch_hi(0)
     , sprite_count(0), sprite_zero_on_line(false)
+    , profile_scanline(0)
 {
+    framebuffer = own_framebuffer;
     for (int i = 0; i < NES_WIDTH * NES_HEIGHT; i++)
-        framebuffer[i] = 0;
+        own_framebuffer[i] = 0;
     for (int i = 0; i < 2048; i++)
         nametable[i] = 0;
     for (int i = 0; i < 32; i++)
@@ -28,6 +37,11 @@ PPU::PPU(Bus& b, Cartridge& c)
         oam[i] = 0;
     for (int i = 0; i < 8; i++)
         secondary_oam[i] = { 0, 0, 0, 0, 0, 0, false };
+
+    // Horizontal until a cartridge is connected (the Bus constructs the
+    // cartridge after the PPU, so it cannot be asked yet)
+    nt_pages[0] = nt_pages[1] = nametable;
+    nt_pages[2] = nt_pages[3] = nametable + 0x400;
 }
 
 void PPU::reset()
@@ -48,34 +62,77 @@ void PPU::reset()
     nmi_occurred = false;
 }
 
+void PPU::connectCartridge()
+{
+    Mapper* mapper = cart.isLoaded() ? cart.getMapper() : nullptr;
+    if (!mapper || cart.getChrRom().empty()) {
+        chr_banks = nullptr;
+        chr_notify = nullptr;
+        updateNametableMap();
+        return;
+    }
+
+    chr_banks = mapper->getChrBanks();
+    chr_notify = mapper->wantsPpuAddr() ? mapper : nullptr;
+    updateNametableMap();
+}
+
+void PPU::updateNametableMap()
+{
+    u8* const lower = nametable;
+    u8* const upper = nametable + 0x400;
+    const Mirroring mirror = cart.isLoaded() ? cart.getMirroring() : Mirroring::HORIZONTAL;
+    u8* const extra = cart.isLoaded() ? cart.getFourScreenVram() : nullptr;
+
+    switch (mirror) {
+    case Mirroring::HORIZONTAL:
+        // Top two nametables (0,1) share memory, bottom two (2,3) share memory
+        nt_pages[0] = lower; nt_pages[1] = lower;
+        nt_pages[2] = upper; nt_pages[3] = upper;
+        break;
+    case Mirroring::SINGLE_LOWER:
+        nt_pages[0] = nt_pages[1] = nt_pages[2] = nt_pages[3] = lower;
+        break;
+    case Mirroring::SINGLE_UPPER:
+        nt_pages[0] = nt_pages[1] = nt_pages[2] = nt_pages[3] = upper;
+        break;
+    case Mirroring::FOUR_SCREEN:
+        if (extra) {
+            nt_pages[0] = lower;        nt_pages[1] = upper;
+            nt_pages[2] = extra;        nt_pages[3] = extra + 0x400;
+            break;
+        }
+        [[fallthrough]];
+    case Mirroring::VERTICAL:
+    default:
+        nt_pages[0] = lower; nt_pages[1] = upper;
+        nt_pages[2] = lower; nt_pages[3] = upper;
+        break;
+    }
+    nametable_generation++;
+}
+
+inline u8 PPU::readChr(u16 addr)
+{
+    if (!chr_banks) return cart.readChr(addr);
+
+    const u8 data = chr_banks[addr >> 10][addr & 0x3FF];
+    if (chr_notify) chr_notify->notifyPpuAddr(addr);
+    return data;
+}
+
 u8 PPU::ppuRead(u16 addr)
 {
     addr &= 0x3FFF;
 
     if (addr < 0x2000) {
         // Pattern tables (CHR ROM/RAM)
-        return cart.readChr(addr);
+        return readChr(addr);
     }
     else if (addr < 0x3F00) {
-        // Nametables
+        // Nametables ($3000-$3EFF mirrors $2000-$2EFF)
         addr &= 0x0FFF;
-        // Handle mirroring
-        Mirroring mirror = cart.getMirroring();
-        if (mirror == Mirroring::VERTICAL) {
-            addr &= 0x07FF;
-        }
-        else if (mirror == Mirroring::HORIZONTAL) {
-            // Horizontal: Top two nametables (0,1) share memory, bottom two (2,3) share memory
-            // Map bit 11 to bit 10, keep bits 0-9
-            addr = ((addr & 0x0800) >> 1) | (addr & 0x03FF);
-        }
-        else if (mirror == Mirroring::SINGLE_LOWER) {
-            addr &= 0x03FF;  // All map to first nametable
-        }
-        else if (mirror == Mirroring::SINGLE_UPPER) {
-            addr = 0x0400 + (addr & 0x03FF);  // All map to second nametable
-        }
-        return nametable[addr & 0x07FF];
+        return nt_pages[addr >> 10][addr & 0x03FF];
     }
     else {
         // Palette
@@ -95,24 +152,10 @@ void PPU::ppuWrite(u16 addr, u8 data)
         cart.writeChr(addr, data);
     }
     else if (addr < 0x3F00) {
-        // Nametables
+        // Nametables ($3000-$3EFF mirrors $2000-$2EFF)
         addr &= 0x0FFF;
-        Mirroring mirror = cart.getMirroring();
-        if (mirror == Mirroring::VERTICAL) {
-            addr &= 0x07FF;
-        }
-        else if (mirror == Mirroring::HORIZONTAL) {
-            // Horizontal: Top two nametables (0,1) share memory, bottom two (2,3) share memory
-            // Map bit 11 to bit 10, keep bits 0-9
-            addr = ((addr & 0x0800) >> 1) | (addr & 0x03FF);
-        }
-        else if (mirror == Mirroring::SINGLE_LOWER) {
-            addr &= 0x03FF;  // All map to first nametable
-        }
-        else if (mirror == Mirroring::SINGLE_UPPER) {
-            addr = 0x0400 + (addr & 0x03FF);  // All map to second nametable
-        }
-        nametable[addr & 0x07FF] = data;
+        nt_pages[addr >> 10][addr & 0x03FF] = data;
+        nametable_generation++;
     }
     else {
         // Palette
@@ -120,6 +163,7 @@ void PPU::ppuWrite(u16 addr, u8 data)
         if (addr == 0x10 || addr == 0x14 || addr == 0x18 || addr == 0x1C)
             addr &= 0x0F;
         palette[addr] = data;
+        palette_generation++;
     }
 }
 
@@ -151,6 +195,61 @@ u8 PPU::readRegister(u16 addr)
     return data;
 }
 
+u8 PPU::peekRegister(u16 addr) const
+{
+    switch (addr & 0x07) {
+    case 2: // PPUSTATUS
+        return (status & 0xE0) | (data_buffer & 0x1F);
+    case 4: // OAMDATA
+        return oam[oam_addr];
+    case 7: // PPUDATA
+        return (v >= 0x3F00) ? peekVram(v) : data_buffer;
+    default:
+        return 0;
+    }
+}
+
+u8 PPU::peekVram(u16 addr) const
+{
+    addr &= 0x3FFF;
+
+    if (addr < 0x2000) {
+        // Straight through the bank pointers, without notifyPpuAddr
+        return chr_banks ? chr_banks[addr >> 10][addr & 0x3FF] : 0;
+    }
+    else if (addr < 0x3F00) {
+        addr &= 0x0FFF;
+        return nt_pages[addr >> 10][addr & 0x03FF];
+    }
+    else {
+        addr &= 0x1F;
+        if (addr == 0x10 || addr == 0x14 || addr == 0x18 || addr == 0x1C)
+            addr &= 0x0F;
+        return palette[addr];
+    }
+}
+
+void PPU::peekVramPage(u8 page, u8* out) const
+{
+    const u16 base = static_cast<u16>((page & 0x3F) << 8);
+
+    // Pattern and nametable pages lie within one 1KB bank
+    const u8* src = nullptr;
+    if (base < 0x2000) {
+        src = chr_banks ? chr_banks[base >> 10] + (base & 0x3FF) : nullptr;
+    } else if (base < 0x3F00) {
+        src = nt_pages[(base & 0x0FFF) >> 10] + (base & 0x03FF);
+    }
+
+    if (src) {
+        std::memcpy(out, src, 256);
+        return;
+    }
+    for (int i = 0; i < 256; i++) {
+        out[i] = peekVram(static_cast<u16>(base + i));
+    }
+}
+
 void PPU::writeRegister(u16 addr, u8 data)
 {
     switch (addr & 0x07) {
@@ -200,6 +299,46 @@ void PPU::writeRegister(u16 addr, u8 data)
     }
 }
 
+void PPU::serialize(StateStream& s)
+{
+    s.io(ctrl);
+    s.io(mask);
+    s.io(status);
+    s.io(oam_addr);
+    s.io(v);
+    s.io(t);
+    s.io(fine_x);
+    s.io(w);
+    s.io(data_buffer);
+    s.io(scanline);
+    s.io(cycle);
+    s.io(odd_frame);
+    s.io(frame_complete);
+    s.io(nmi_occurred);
+    s.io(nametable);
+    s.io(palette);
+    s.io(oam);
+    s.io(nt_byte);
+    s.io(at_byte);
+    s.io(bg_lo);
+    s.io(bg_hi);
+    s.io(bg_shifter_lo);
+    s.io(bg_shifter_hi);
+    s.io(at_shifter_lo);
+    s.io(at_shifter_hi);
+    s.io(at_latch_lo);
+    s.io(at_latch_hi);
+    s.io(secondary_oam);
+    s.io(sprite_count);
+    s.io(sprite_zero_on_line);
+    s.io(scanline_buffer);
+
+    if (s.isLoading()) {
+        nametable_generation++;
+        palette_generation++;
+    }
+}
+
 void PPU::writeDMA(u8 data)
 {
     // OAM DMA - transfer 256 bytes from CPU memory
@@ -209,10 +348,47 @@ void PPU::writeDMA(u8 data)
     }
 }
 
-u32 PPU::getColorFromPalette(u8 pal, u8 pixel)
+// ARGB for every colour index: 64 palette colours x 8 emphasis combinations
+// x greyscale. Greyscale keeps only the colour's luma row (bits 4-5); each
+// emphasis bit (red, green, blue) then dims the two other channels.
+static std::array<u32, NES_COLOR_COUNT> buildArgbTable()
+{
+    std::array<u32, NES_COLOR_COUNT> table{};
+    for (u32 index = 0; index < NES_COLOR_COUNT; index++) {
+        const u32 color = (index & 0x200) ? (index & 0x30) : (index & 0x3F);
+        const u32 emphasis = (index >> 6) & 7;
+
+        u32 rgb = nesPalette[color];
+        if (emphasis) {
+            u32 out = 0;
+            for (u32 channel = 0; channel < 3; channel++) {
+                // channel 0 = red (bits 16-23), 1 = green, 2 = blue
+                const u32 shift = 16 - channel * 8;
+                u32 value = (rgb >> shift) & 0xFF;
+                if (emphasis & ~(1u << channel)) {
+                    value = value * 3 / 4;
+                }
+                out |= value << shift;
+            }
+            rgb = out;
+        }
+        table[index] = rgb | 0xFF000000;  // Add alpha
+    }
+    return table;
+}
+
+const u32* PPU::getArgbTable()
 {
-    u8 index = ppuRead(0x3F00 + (pal << 2) + pixel) & 0x3F;
-    return nesPalette[index] | 0xFF000000;  // Add alpha
+    static const std::array<u32, NES_COLOR_COUNT> argb = buildArgbTable();
+    return argb.data();
+}
+
+void PPU::toARGB(const u16* indices, u32* out, size_t count)
+{
+    const u32* argb = getArgbTable();
+    for (size_t i = 0; i < count; i++) {
+        out[i] = argb[indices[i] & (NES_COLOR_COUNT - 1)];
+    }
 }
 
 void PPU::fillScanlineBuffer()
@@ -299,8 +475,22 @@ void PPU::renderScanlineBurst()
     if (scanline < 0 || scanline >= NES_HEIGHT)
         return;
 
+#ifdef VNES_PROFILER
+    // Timing all 240 bursts would cost two clock reads and an atomic add per
+    // scanline; one scanline a frame is timed instead, moving through the
+    // picture, and counted for the whole frame
+    const bool profiled = scanline == profile_scanline;
+    if (profiled) {
+        profile_scanline = (profile_scanline + 7) % NES_HEIGHT;
+    }
+    VNES_PROFILE_SAMPLE_SCOPE(ProfileStage::PpuRender, profiled, NES_HEIGHT);
+#endif
+
     int y = scanline;
-    u32* line = &framebuffer[y * NES_WIDTH];
+    u16* line = &framebuffer[y * NES_WIDTH];
+    // Emphasis (PPUMASK bits 5-7) and greyscale (bit 0) ride along in the
+    // colour index; toARGB's table applies them
+    const u16 mask_bits = static_cast<u16>(((mask & 0xE0) << 1) | ((mask & 0x01) << 9));
 
     // Render all 256 pixels in one burst
     for (int x = 0; x < 256; x++) {
@@ -343,8 +533,16 @@ void PPU::renderScanlineBurst()
             }
         }
 
-        // Write final color directly to framebuffer
-        line[x] = getColorFromPalette(final_palette, final_pixel);
+        // Resolve the palette RAM entry (pixel 0 only ever occurs with
+        // palette 0, so the $3F10/$3F14/... mirrors never come into play)
+        line[x] = static_cast<u16>((palette[(final_palette << 2) | final_pixel] & 0x3F) | mask_bits);
+    }
+}
+
+void PPU::run(u32 dots)
+{
+    while (dots--) {
+        step();
     }
 }
 
@@ -429,7 +627,7 @@ void PPU::step()
                         }
                         pattern_addr = (table << 12) | (tile << 4) | sprite_y_offset;
                     }
-                    secondary_oam[fetch_cycle].pattern_lo = ppuRead(pattern_addr);
+                    secondary_oam[fetch_cycle].pattern_lo = readChr(pattern_addr);
                 }
                 else if (phase == 7) {
                     // Fetch pattern high byte
@@ -459,7 +657,7 @@ void PPU::step()
                         }
                         pattern_addr = (table << 12) | (tile << 4) | sprite_y_offset | 8;
                     }
-                    secondary_oam[fetch_cycle].pattern_hi = ppuRead(pattern_addr);
+                    secondary_oam[fetch_cycle].pattern_hi = readChr(pattern_addr);
                 }
             }
         }
@@ -492,10 +690,10 @@ void PPU::step()
                 at_byte &= 0x03;
                 break;
             case 5:  // Pattern low
-                bg_lo = ppuRead(((ctrl & 0x10) << 8) + (nt_byte << 4) + ((v >> 12) & 0x07));
+                bg_lo = readChr(((ctrl & 0x10) << 8) + (nt_byte << 4) + ((v >> 12) & 0x07));
                 break;
             case 7:  // Pattern high
-                bg_hi = ppuRead(((ctrl & 0x10) << 8) + (nt_byte << 4) + ((v >> 12) & 0x07) + 8);
+                bg_hi = readChr(((ctrl & 0x10) << 8) + (nt_byte << 4) + ((v >> 12) & 0x07) + 8);
                 break;
             case 0:  // Increment horizontal
                 if (mask & 0x18) {  // Rendering enabled
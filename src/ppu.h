@@ -2,36 +2,78 @@
 #define PPU_H
 
 #include "types.h"
+#include <cstddef>
 
 // Forward declarations
 class Bus;
 class Cartridge;
+class StateStream;
+class Mapper;
 
 // Screen dimensions
 static const int NES_WIDTH = 256;
 static const int NES_HEIGHT = 240;
 
+// Distinct framebuffer values: 64 colours x 8 emphasis combinations x
+// greyscale on/off
+static const int NES_COLOR_COUNT = 1024;
+
 class PPU {
 public:
     explicit PPU(Bus& bus, Cartridge& cart);
     void reset();
+
+    // Pick up the CHR bank pointers of a newly loaded cartridge
+    void connectCartridge();
+
+    // Rebuild the nametable map after the cartridge changed mirroring
+    void updateNametableMap();
     void step();
 
+    // Advance the PPU by a batch of dots (3 per CPU cycle)
+    void run(u32 dots);
+
     // CPU interface (memory-mapped registers $2000-$2007)
     u8 readRegister(u16 addr);
     void writeRegister(u16 addr, u8 data);
 
+    // Debugger reads without side effects: the value readRegister would
+    // return (no vblank clear, no PPUDATA buffer or address update), and
+    // PPU address space ($0000-$3FFF) without triggering mapper CHR latches.
+    // peekVramPage copies the 256 bytes at page << 8 into `out`.
+    u8 peekRegister(u16 addr) const;
+    u8 peekVram(u16 addr) const;
+    void peekVramPage(u8 page, u8* out) const;
+
     // OAM DMA
     void writeDMA(u8 data);
 
+    // Save-state support (everything except the framebuffer, which the
+    // next emulated frame redraws)
+    void serialize(StateStream& s);
+
     // State
     bool isFrameComplete() const { return frame_complete; }
     void clearFrameComplete() { frame_complete = false; }
     bool isNMI() const { return nmi_occurred; }
     void clearNMI() { nmi_occurred = false; }
 
-    // Framebuffer access (RGB format)
-    const u32* getFramebuffer() const { return framebuffer; }
+    // Framebuffer access. Pixels are NES colour indices: bits 0-5 the
+    // palette colour, bits 6-8 the PPUMASK emphasis bits and bit 9 the
+    // PPUMASK greyscale bit. Conversion to ARGB is left to the consumer (see
+    // toARGB).
+    const u16* getFramebuffer() const { return framebuffer; }
+
+    // Render into `target` (NES_WIDTH * NES_HEIGHT pixels) instead of the
+    // PPU's own buffer, e.g. a slot of the display's frame ring; nullptr
+    // switches back. Every visible pixel is rewritten each frame.
+    void setFramebuffer(u16* target) { framebuffer = target ? target : own_framebuffer; }
+
+    // Convert `count` framebuffer pixels to 0xAARRGGBB
+    static void toARGB(const u16* indices, u32* out, size_t count);
+
+    // 0xAARRGGBB of every framebuffer value (NES_COLOR_COUNT entries)
+    static const u32* getArgbTable();
 
     // For debugging
     int getScanline() const { return scanline; }
@@ -67,19 +109,42 @@ public:
     u8 getNametableByte(u16 addr) const { return nametable[addr & 0x7FF]; }
     const u8* getNametable() const { return nametable; }
 
+    // Logical nametable `index` (0-3, $2000/$2400/$2800/$2C00) after mirroring
+    const u8* getNametablePage(int index) const { return nt_pages[index & 3]; }
+
+    // Bumped on every nametable/palette write, mirroring change and state
+    // load, so debug viewers only redecode what changed
+    u32 getNametableGeneration() const { return nametable_generation; }
+    u32 getPaletteGeneration() const { return palette_generation; }
+
 private:
     // Internal VRAM access
     u8 ppuRead(u16 addr);
     void ppuWrite(u16 addr, u8 data);
 
+    // Pattern table read through the mapper's 1KB bank pointers
+    u8 readChr(u16 addr);
+
     // Bus and Cartridge references
     Bus& bus;
     Cartridge& cart;
 
+    // Mapper-published CHR banks (nullptr until a cartridge is connected)
+    // and whether the mapper watches pattern fetch addresses (MMC2 latches)
+    const u8* const* chr_banks;
+    Mapper* chr_notify;
+
+    // The four logical nametables ($2000/$2400/$2800/$2C00) as 1KB slices
+    // of nametable[] or of the cartridge's four-screen VRAM
+    u8* nt_pages[4];
+
+    // Change counters for the debug viewers (see getNametableGeneration)
+    u32 nametable_generation;
+    u32 palette_generation;
+
     // Rendering helpers
     void fillScanlineBuffer();
     void renderScanlineBurst();
-    u32 getColorFromPalette(u8 palette, u8 pixel);
 
     // Registers
     u8 ctrl;        // $2000 PPUCTRL
@@ -144,8 +209,12 @@ private:
     };
     ScanlineData scanline_buffer;
 
-    // Output
-    u32 framebuffer[NES_WIDTH * NES_HEIGHT];
+    // The one scanline per frame whose burst is timed for the profiler
+    int profile_scanline;
+
+    // Output (colour indices, see getFramebuffer)
+    u16* framebuffer;
+    u16 own_framebuffer[NES_WIDTH * NES_HEIGHT];
 };
 
 #endif // PPU_H
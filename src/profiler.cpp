@@ -0,0 +1,174 @@
+#include "profiler.h"
+#include <chrono>
+#include <fstream>
+
+static const std::chrono::steady_clock::time_point profilerEpoch = std::chrono::steady_clock::now();
+
+Profiler::Profiler()
+    : frame_count(0), frame_start_ns(0), tracing(false)
+{
+    for (auto& a : accum_ns) {
+        a.store(0, std::memory_order_relaxed);
+    }
+}
+
+Profiler& Profiler::instance()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+const char* Profiler::getStageName(ProfileStage stage)
+{
+    switch (stage) {
+        case ProfileStage::Emulation:     return "Emulation";
+        case ProfileStage::PpuRender:     return "PPU Render";
+        case ProfileStage::Scaler:        return "HQ2x Scaler";
+        case ProfileStage::TextureUpload: return "Texture Upload";
+        case ProfileStage::GuiRender:     return "GUI Render";
+        default:                          return "Frame";
+    }
+}
+
+u64 Profiler::now()
+{
+    return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - profilerEpoch).count());
+}
+
+u32 Profiler::threadIndex()
+{
+    static std::atomic<u32> next_thread{ 1 };
+    thread_local const u32 index = next_thread.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+void Profiler::record(ProfileStage stage, u64 start_ns, u64 duration_ns)
+{
+    accum_ns[static_cast<size_t>(stage)].fetch_add(duration_ns, std::memory_order_relaxed);
+
+    if (tracing.load(std::memory_order_relaxed)) {
+        addTraceEvent(static_cast<u8>(stage), start_ns, duration_ns);
+    }
+}
+
+void Profiler::recordSample(ProfileStage stage, u64 start_ns, u64 duration_ns, u32 weight)
+{
+    accum_ns[static_cast<size_t>(stage)].fetch_add(duration_ns * weight, std::memory_order_relaxed);
+
+    if (tracing.load(std::memory_order_relaxed)) {
+        addTraceEvent(static_cast<u8>(stage), start_ns, duration_ns);
+    }
+}
+
+void Profiler::addTraceEvent(u8 stage, u64 start_ns, u64 duration_ns)
+{
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    if (trace_events.size() >= MAX_TRACE_EVENTS) return;
+    trace_events.push_back({ start_ns, duration_ns, threadIndex(), stage });
+}
+
+void Profiler::endFrame()
+{
+    const u64 t = now();
+
+    FrameStats& stats = history[frame_count % HISTORY_FRAMES];
+    stats.frame_ms = frame_start_ns ? static_cast<float>(t - frame_start_ns) / 1e6f : 0.0f;
+    for (size_t i = 0; i < STAGE_COUNT; i++) {
+        stats.stage_ms[i] = static_cast<float>(accum_ns[i].exchange(0, std::memory_order_relaxed)) / 1e6f;
+    }
+
+    if (frame_start_ns && tracing.load(std::memory_order_relaxed)) {
+        addTraceEvent(static_cast<u8>(STAGE_COUNT), frame_start_ns, t - frame_start_ns);
+    }
+
+    frame_start_ns = t;
+    frame_count++;
+}
+
+const Profiler::FrameStats& Profiler::getFrame(size_t index) const
+{
+    // index 0 is the oldest frame still in the ring
+    const size_t count = getFrameCount();
+    const size_t first = frame_count - count;
+    return history[(first + index) % HISTORY_FRAMES];
+}
+
+void Profiler::getStageHistory(ProfileStage stage, std::vector<float>& out) const
+{
+    const size_t count = getFrameCount();
+    out.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        out[i] = getFrame(i).stage_ms[static_cast<size_t>(stage)];
+    }
+}
+
+void Profiler::getFrameTimeHistory(std::vector<float>& out) const
+{
+    const size_t count = getFrameCount();
+    out.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        out[i] = getFrame(i).frame_ms;
+    }
+}
+
+Profiler::FrameStats Profiler::getAverage() const
+{
+    FrameStats avg;
+    const size_t count = getFrameCount();
+    if (count == 0) return avg;
+
+    for (size_t i = 0; i < count; i++) {
+        const FrameStats& f = getFrame(i);
+        avg.frame_ms += f.frame_ms;
+        for (size_t s = 0; s < STAGE_COUNT; s++) {
+            avg.stage_ms[s] += f.stage_ms[s];
+        }
+    }
+
+    avg.frame_ms /= count;
+    for (auto& ms : avg.stage_ms) {
+        ms /= count;
+    }
+    return avg;
+}
+
+void Profiler::startTrace()
+{
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    trace_events.clear();
+    trace_events.reserve(64 * 1024);
+    tracing.store(true, std::memory_order_relaxed);
+}
+
+void Profiler::stopTrace()
+{
+    tracing.store(false, std::memory_order_relaxed);
+}
+
+size_t Profiler::getTraceEventCount() const
+{
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    return trace_events.size();
+}
+
+bool Profiler::writeChromeTrace(const std::string& path) const
+{
+    std::ofstream file(path);
+    if (!file) return false;
+
+    std::lock_guard<std::mutex> lock(trace_mutex);
+
+    // Trace Event Format: complete ("X") events, timestamps in microseconds
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"VNES\"}}";
+    for (const auto& e : trace_events) {
+        file << ",\n{\"name\":\"" << getStageName(static_cast<ProfileStage>(e.stage))
+             << "\",\"cat\":\"vnes\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.thread
+             << ",\"ts\":" << (e.start_ns / 1000) << "." << ((e.start_ns / 100) % 10)
+             << ",\"dur\":" << (e.duration_ns / 1000) << "." << ((e.duration_ns / 100) % 10) << "}";
+    }
+    file << "\n]}\n";
+
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,148 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "types.h"
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Lightweight per-frame stage profiler.
+//
+// Code is instrumented with VNES_PROFILE_SCOPE(stage); each scope adds its
+// duration to the stage's total for the current host frame. The main loop
+// calls VNES_PROFILE_FRAME() once per frame to close the frame into a ring
+// buffer that the GUI "Performance" window plots. While a capture is running
+// every scope is also recorded as a Chrome trace event (chrome://tracing,
+// Perfetto).
+//
+// Build with VNES_PROFILER defined to enable; otherwise the macros expand to
+// nothing and instrumented code carries no overhead.
+
+enum class ProfileStage : u8 {
+    Emulation,      // Bus::runFrame (CPU + PPU + APU)
+    PpuRender,      // PPU::renderScanlineBurst, sampled (part of Emulation)
+    Scaler,         // Display::scalerThreadLoop HQ2x pass (scaler thread)
+    TextureUpload,  // Display::update texture upload
+    GuiRender,      // Gui::build + Gui::render
+    Count
+};
+
+class Profiler {
+public:
+    static const size_t STAGE_COUNT = static_cast<size_t>(ProfileStage::Count);
+    static const size_t HISTORY_FRAMES = 240;
+    static const size_t MAX_TRACE_EVENTS = 1 << 20;
+
+    struct FrameStats {
+        float frame_ms = 0.0f;                       // host frame time
+        std::array<float, STAGE_COUNT> stage_ms{};   // summed time per stage
+    };
+
+    static Profiler& instance();
+    static const char* getStageName(ProfileStage stage);
+
+    // Nanoseconds since the profiler was created (steady clock)
+    static u64 now();
+
+    // Add one timed scope (thread-safe)
+    void record(ProfileStage stage, u64 start_ns, u64 duration_ns);
+
+    // Add one timed scope that stands for `weight` identical ones: the stage
+    // total grows by duration * weight, the trace shows the real duration
+    void recordSample(ProfileStage stage, u64 start_ns, u64 duration_ns, u32 weight);
+
+    // Close the current frame into the history ring (main thread)
+    void endFrame();
+
+    // History, oldest first (main thread)
+    size_t getFrameCount() const { return frame_count < HISTORY_FRAMES ? frame_count : HISTORY_FRAMES; }
+    const FrameStats& getFrame(size_t index) const;
+    void getStageHistory(ProfileStage stage, std::vector<float>& out) const;
+    void getFrameTimeHistory(std::vector<float>& out) const;
+    FrameStats getAverage() const;
+
+    // Chrome trace-event capture
+    void startTrace();
+    void stopTrace();
+    bool isTracing() const { return tracing.load(std::memory_order_relaxed); }
+    size_t getTraceEventCount() const;
+    bool writeChromeTrace(const std::string& path) const;
+
+private:
+    Profiler();
+
+    struct TraceEvent {
+        u64 start_ns;
+        u64 duration_ns;
+        u32 thread;
+        u8 stage;       // ProfileStage, or STAGE_COUNT for the frame marker
+    };
+
+    static u32 threadIndex();
+    void addTraceEvent(u8 stage, u64 start_ns, u64 duration_ns);
+
+    // Current frame accumulators (written from any thread)
+    std::array<std::atomic<u64>, STAGE_COUNT> accum_ns;
+
+    // History ring (main thread only)
+    std::array<FrameStats, HISTORY_FRAMES> history;
+    size_t frame_count;
+    u64 frame_start_ns;
+
+    // Trace capture
+    std::atomic<bool> tracing;
+    mutable std::mutex trace_mutex;
+    std::vector<TraceEvent> trace_events;
+};
+
+// Times the enclosing scope for one stage
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfileStage s) : stage(s), start(Profiler::now()) {}
+    ~ProfileScope() { Profiler::instance().record(stage, start, Profiler::now() - start); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ProfileStage stage;
+    u64 start;
+};
+
+// Times the enclosing scope only if `active`, counting it `weight` times. For
+// code that runs too often to time every call (e.g. once per scanline)
+class ProfileSampleScope {
+public:
+    ProfileSampleScope(ProfileStage s, bool active, u32 w)
+        : stage(s), weight(w), start(active ? Profiler::now() : 0), timed(active) {}
+    ~ProfileSampleScope()
+    {
+        if (timed) Profiler::instance().recordSample(stage, start, Profiler::now() - start, weight);
+    }
+
+    ProfileSampleScope(const ProfileSampleScope&) = delete;
+    ProfileSampleScope& operator=(const ProfileSampleScope&) = delete;
+
+private:
+    ProfileStage stage;
+    u32 weight;
+    u64 start;
+    bool timed;
+};
+
+#ifdef VNES_PROFILER
+#define VNES_PROFILE_CONCAT_INNER(a, b) a##b
+#define VNES_PROFILE_CONCAT(a, b) VNES_PROFILE_CONCAT_INNER(a, b)
+#define VNES_PROFILE_SCOPE(stage) ProfileScope VNES_PROFILE_CONCAT(profile_scope_, __LINE__)(stage)
+#define VNES_PROFILE_SAMPLE_SCOPE(stage, active, weight) \
+    ProfileSampleScope VNES_PROFILE_CONCAT(profile_scope_, __LINE__)(stage, active, weight)
+#define VNES_PROFILE_FRAME() Profiler::instance().endFrame()
+#else
+#define VNES_PROFILE_SCOPE(stage) ((void)0)
+#define VNES_PROFILE_SAMPLE_SCOPE(stage, active, weight) ((void)0)
+#define VNES_PROFILE_FRAME() ((void)0)
+#endif
+
+#endif // PROFILER_H
@@ -0,0 +1,159 @@
+#include "rewind.h"
+#include <algorithm>
+#include <cstring>
+
+// Delta encoding: a sequence of tokens
+//   u16 zero_run     bytes unchanged from the successor
+//   u16 literal_len  followed by that many XOR bytes
+static const size_t MAX_RUN = 0xFFFF;
+
+static void putU16(std::vector<u8>& out, size_t value)
+{
+    out.push_back(static_cast<u8>(value & 0xFF));
+    out.push_back(static_cast<u8>(value >> 8));
+}
+
+static size_t getU16(const u8* p)
+{
+    return static_cast<size_t>(p[0]) | (static_cast<size_t>(p[1]) << 8);
+}
+
+RewindBuffer::RewindBuffer(size_t budget_bytes, size_t max_frames)
+    : arena(new u8[budget_bytes])
+    , capacity(budget_bytes)
+    , head(0)
+    , used(0)
+    , max_frames(max_frames)
+    , has_current(false)
+{
+}
+
+void RewindBuffer::clear()
+{
+    entries.clear();
+    head = 0;
+    used = 0;
+    current.clear();
+    has_current = false;
+}
+
+void RewindBuffer::encodeDelta(std::span<const u8> older, std::span<const u8> newer)
+{
+    scratch.clear();
+
+    const size_t n = older.size();
+    size_t i = 0;
+    while (i < n) {
+        size_t zeros = 0;
+        while (i < n && zeros < MAX_RUN && older[i] == newer[i]) {
+            zeros++;
+            i++;
+        }
+
+        // A literal run ends at the first pair of unchanged bytes, so single
+        // matching bytes inside a changed region don't cost a whole token
+        const size_t start = i;
+        while (i < n && i - start < MAX_RUN) {
+            if (older[i] == newer[i] && (i + 1 >= n || older[i + 1] == newer[i + 1])) break;
+            i++;
+        }
+
+        putU16(scratch, zeros);
+        putU16(scratch, i - start);
+        for (size_t j = start; j < i; j++) {
+            scratch.push_back(older[j] ^ newer[j]);
+        }
+    }
+}
+
+void RewindBuffer::applyDelta(const Entry& entry)
+{
+    const u8* p = &arena[entry.offset];
+    const u8* end = p + entry.size;
+    size_t pos = 0;
+
+    while (p + 4 <= end) {
+        pos += getU16(p);
+        const size_t literals = getU16(p + 2);
+        p += 4;
+        for (size_t j = 0; j < literals; j++) {
+            current[pos++] ^= *p++;
+        }
+    }
+}
+
+void RewindBuffer::dropOldest()
+{
+    used -= entries.front().size;
+    entries.pop_front();
+}
+
+bool RewindBuffer::store(const std::vector<u8>& blob)
+{
+    if (blob.size() > capacity) return false;
+
+    // Not enough room before the end of the arena: everything still stored
+    // past `head` is older than what sits below it, so drop it and wrap
+    if (head + blob.size() > capacity) {
+        while (!entries.empty() && entries.front().offset >= head) {
+            dropOldest();
+        }
+        head = 0;
+    }
+
+    // Drop the oldest entries overlapping the target range
+    while (!entries.empty() && entries.front().offset >= head &&
+           entries.front().offset < head + blob.size()) {
+        dropOldest();
+    }
+
+    if (!blob.empty()) {
+        std::memcpy(&arena[head], blob.data(), blob.size());
+    }
+    entries.push_back({ head, blob.size() });
+    head += blob.size();
+    used += blob.size();
+    return true;
+}
+
+void RewindBuffer::push(std::span<const u8> state)
+{
+    // A snapshot of a different size (new ROM) cannot be chained
+    if (has_current && current.size() != state.size()) {
+        clear();
+    }
+
+    if (has_current) {
+        encodeDelta(current, state);
+        if (!store(scratch)) {
+            clear();
+        }
+        while (entries.size() + 1 > max_frames) {
+            dropOldest();
+        }
+    }
+
+    current.assign(state.begin(), state.end());
+    has_current = true;
+}
+
+bool RewindBuffer::pop(std::vector<u8>& state)
+{
+    if (!has_current) return false;
+
+    state = current;
+
+    if (entries.empty()) {
+        current.clear();
+        has_current = false;
+        return true;
+    }
+
+    // Step `current` back to its predecessor and reclaim the delta's space
+    const Entry entry = entries.back();
+    applyDelta(entry);
+    entries.pop_back();
+    used -= entry.size;
+    head = entry.offset;
+    return true;
+}
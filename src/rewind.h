@@ -0,0 +1,65 @@
+#ifndef REWIND_H
+#define REWIND_H
+
+#include "types.h"
+#include <deque>
+#include <memory>
+#include <span>
+#include <vector>
+
+// Rewind history built on Bus::saveState snapshots.
+//
+// Only the newest snapshot is kept whole. Every older one is stored as the
+// XOR of it against its successor, run-length encoded: RAM, VRAM and the
+// mapper barely change between frames, so most of the delta is zero runs and
+// a frame typically costs a few hundred bytes. Deltas live in a fixed-size
+// ring arena; when it (or the frame limit) is full the oldest frames are
+// dropped. Stepping back one frame decodes a single delta.
+class RewindBuffer {
+public:
+    static const size_t DEFAULT_BUDGET = 64 * 1024 * 1024;
+    static const size_t DEFAULT_MAX_FRAMES = 60 * 60;   // 60 s at 60 FPS
+
+    explicit RewindBuffer(size_t budget_bytes = DEFAULT_BUDGET, size_t max_frames = DEFAULT_MAX_FRAMES);
+
+    // Drop all history (e.g. after loading another ROM)
+    void clear();
+
+    // Record the state at the start of a frame
+    void push(std::span<const u8> state);
+
+    // Remove the newest state and copy it to `state`; false when empty
+    bool pop(std::vector<u8>& state);
+
+    // Number of states that can be stepped back through
+    size_t getFrameCount() const { return has_current ? entries.size() + 1 : 0; }
+    size_t getMaxFrames() const { return max_frames; }
+
+    // Bytes held by deltas plus the newest full snapshot
+    size_t getMemoryUsed() const { return used + current.size(); }
+    size_t getBudget() const { return capacity; }
+
+private:
+    struct Entry {
+        size_t offset;
+        size_t size;
+    };
+
+    void encodeDelta(std::span<const u8> older, std::span<const u8> newer);
+    void applyDelta(const Entry& entry);
+    bool store(const std::vector<u8>& blob);
+    void dropOldest();
+
+    std::unique_ptr<u8[]> arena;    // left uninitialized so untouched pages stay uncommitted
+    size_t capacity;
+    std::deque<Entry> entries;      // oldest first
+    size_t head;                    // next write offset in the arena
+    size_t used;                    // bytes of live entries
+    size_t max_frames;
+
+    std::vector<u8> current;        // newest snapshot, uncompressed
+    bool has_current;
+    std::vector<u8> scratch;        // encode buffer
+};
+
+#endif // REWIND_H
@@ -0,0 +1,85 @@
+#ifndef SAVESTATE_H
+#define SAVESTATE_H
+
+#include "types.h"
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+// Binary snapshot stream used by Bus::saveState/loadState.
+//
+// Components implement a single serialize(StateStream&) that lists their
+// fields once; the same call writes them when saving and reads them back
+// when loading, so the two directions cannot drift apart. Values are raw
+// little-endian host copies: snapshots are meant for the same build (rewind,
+// run-ahead, quick save), and the header version guards format changes.
+class StateStream {
+public:
+    // Saving: fields are appended to `out`
+    explicit StateStream(std::vector<u8>& out)
+        : output(&out), input(), pos(0), error(false) {}
+
+    // Loading: fields are read from `in`
+    explicit StateStream(std::span<const u8> in)
+        : output(nullptr), input(in), pos(0), error(false) {}
+
+    bool isLoading() const { return output == nullptr; }
+
+    // False once a read ran past the end or a size check failed
+    bool ok() const { return !error; }
+    void fail() { error = true; }
+
+    // True when every input byte has been consumed
+    bool atEnd() const { return pos == input.size(); }
+
+    template<typename T>
+    void io(T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "StateStream::io needs a trivially copyable type");
+        bytes(&value, sizeof(T));
+    }
+
+    template<typename T, size_t N>
+    void io(T (&array)[N])
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "StateStream::io needs a trivially copyable type");
+        bytes(array, sizeof(T) * N);
+    }
+
+    // Fixed-size buffers (PRG-RAM, CHR-RAM): the stored length must match
+    void io(std::vector<u8>& buffer)
+    {
+        u32 size = static_cast<u32>(buffer.size());
+        io(size);
+        if (size != buffer.size()) {
+            error = true;
+            return;
+        }
+        bytes(buffer.data(), buffer.size());
+    }
+
+    void bytes(void* data, size_t size)
+    {
+        if (output) {
+            const u8* src = static_cast<const u8*>(data);
+            output->insert(output->end(), src, src + size);
+            return;
+        }
+
+        if (error || input.size() - pos < size) {
+            error = true;
+            return;
+        }
+        std::memcpy(data, input.data() + pos, size);
+        pos += size;
+    }
+
+private:
+    std::vector<u8>* output;
+    std::span<const u8> input;
+    size_t pos;
+    bool error;
+};
+
+#endif // SAVESTATE_H
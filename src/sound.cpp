@@ -1,13 +1,10 @@
 #include "sound.h"
-#include "apu.h"
 #include <cstring>
 #include <algorithm>
 
-Sound::Sound() 
-    : initialized(false)
+Sound::Sound()
 {
     std::memset(samples, 0, sizeof(samples));
-    sample_buffer.resize(MAX_BUFFER_SIZE);
 }
 
 Sound::~Sound()
@@ -27,50 +24,54 @@ void Sound::stop()
     sf::SoundStream::stop();
 }
 
-void Sound::pushSample(float sample)
+void Sound::pushSamples(const float* input, size_t count)
 {
-    // DC-block filter to reduce low-frequency offsets
-    float filtered = sample - dc_prev_input + (DC_BLOCK_R * dc_prev_output);
-    dc_prev_input = sample;
-    dc_prev_output = filtered;
+    while (count > 0) {
+        const size_t n = count < BLOCK_SIZE ? count : BLOCK_SIZE;
+        for (size_t i = 0; i < n; i++) {
+            // DC-block filter to reduce low-frequency offsets
+            float filtered = input[i] - dc_prev_input + (DC_BLOCK_R * dc_prev_output);
+            dc_prev_input = input[i];
+            dc_prev_output = filtered;
 
-    // Clamp and convert to 16-bit
-    if (filtered > 1.0f) filtered = 1.0f;
-    if (filtered < -1.0f) filtered = -1.0f;
-    
-    s16 int_sample = static_cast<s16>(filtered * 32767.0f);
+            // Clamp and convert to 16-bit
+            if (filtered > 1.0f) filtered = 1.0f;
+            if (filtered < -1.0f) filtered = -1.0f;
+
+            block[i] = static_cast<s16>(filtered * 32767.0f);
+        }
 
-    std::lock_guard<std::mutex> lock(buffer_mutex);
-    sample_buffer[buffer_write] = int_sample;
-    buffer_write = (buffer_write + 1) % MAX_BUFFER_SIZE;
-    if (buffer_count < MAX_BUFFER_SIZE) {
-        buffer_count++;
-    } else {
-        // Overwrite oldest sample when buffer is full
-        buffer_read = (buffer_read + 1) % MAX_BUFFER_SIZE;
+        // One release store publishes the whole block to the audio thread
+        sample_ring.write(block, n);
+        input += n;
+        count -= n;
     }
 }
 
-bool Sound::onGetData(Chunk& data)
+double Sound::nextRateScale()
 {
-    size_t samples_to_copy = 0;
+    fill_average += (static_cast<double>(sample_ring.size()) - fill_average) / 32.0;
 
-    {
-        std::lock_guard<std::mutex> lock(buffer_mutex);
-        samples_to_copy = std::min(buffer_count, (size_t)BUFFER_SIZE);
-        for (size_t i = 0; i < samples_to_copy; i++) {
-            samples[i] = sample_buffer[buffer_read];
-            buffer_read = (buffer_read + 1) % MAX_BUFFER_SIZE;
-        }
-        buffer_count -= samples_to_copy;
-        if (samples_to_copy > 0) {
-            last_sample = samples[samples_to_copy - 1];
-        }
+    // Proportional term: full adjustment when the ring is empty or twice the
+    // target. The integral term (~10 s to build up) absorbs a steady clock
+    // offset so the fill settles on the target rather than beside it.
+    const double error = std::clamp((static_cast<double>(TARGET_FILL) - fill_average) / TARGET_FILL, -1.0, 1.0);
+    rate_integral = std::clamp(rate_integral + error * MAX_RATE_ADJUST / 600.0, -MAX_RATE_ADJUST, MAX_RATE_ADJUST);
+    const double scale = 1.0 + std::clamp(error * MAX_RATE_ADJUST + rate_integral, -MAX_RATE_ADJUST, MAX_RATE_ADJUST);
+    rate_scale.store(scale, std::memory_order_relaxed);
+    return scale;
+}
+
+bool Sound::onGetData(Chunk& data)
+{
+    const size_t samples_copied = sample_ring.read(samples, BUFFER_SIZE);
+    if (samples_copied > 0) {
+        last_sample = samples[samples_copied - 1];
     }
 
     // Fill remaining with last sample to avoid hard clicks
-    if (samples_to_copy < BUFFER_SIZE) {
-        std::fill(samples + samples_to_copy, samples + BUFFER_SIZE, last_sample);
+    if (samples_copied < BUFFER_SIZE) {
+        std::fill(samples + samples_copied, samples + BUFFER_SIZE, last_sample);
     }
     
     data.samples = samples;
@@ -2,11 +2,12 @@
 #define SOUND_H
 
 #include "types.h"
+#include "audio_sink.h"
+#include "spsc_ring.h"
 #include <SFML/Audio.hpp>
-#include <vector>
-#include <mutex>
+#include <atomic>
 
-class Sound : public sf::SoundStream {
+class Sound : public sf::SoundStream, public AudioSink {
 public:
     Sound();
     ~Sound();
@@ -14,12 +15,22 @@ public:
     void start();
     void stop();
     
-    // Called from emulation thread to push samples
-    void pushSample(float sample);
+    // Called from emulation thread with each frame's samples
+    void pushSamples(const float* samples, size_t count) override;
+
+    // Dynamic rate control (emulation thread): the host clock that paces
+    // emulation and the audio device clock drift apart, so the APU stretches
+    // its output by up to MAX_RATE_ADJUST to hold the ring around
+    // TARGET_FILL samples instead of letting it drain or overflow
+    double nextRateScale() override;
+
+    static const size_t TARGET_FILL = 4096;     // two device chunks, ~93 ms
+    static constexpr double MAX_RATE_ADJUST = 0.005;
+
+    // For the GUI (any thread)
+    size_t getBufferedSamples() const { return sample_ring.size(); }
+    double getRateScale() const { return rate_scale.load(std::memory_order_relaxed); }
 
-    // has been initialized with a valid sound device
-    bool initialized;
-    
 private:
     // SoundStream interface
     virtual bool onGetData(Chunk& data) override;
@@ -28,22 +39,26 @@ private:
     static const unsigned int SAMPLE_RATE = 44100;
     static const unsigned int CHANNEL_COUNT = 1; // Mono
     static const unsigned int BUFFER_SIZE = 2048;
+    static const size_t BLOCK_SIZE = 1024;
 
-    s16 samples[BUFFER_SIZE];
-
-    std::vector<s16> sample_buffer;
-    size_t buffer_read = 0;
-    size_t buffer_write = 0;
-    size_t buffer_count = 0;
+    s16 samples[BUFFER_SIZE];   // audio thread's chunk
+    s16 block[BLOCK_SIZE];      // emulation thread's converted samples
     s16 last_sample = 0;
-    std::mutex buffer_mutex;
+
+    // Emulation thread -> audio thread, ~0.74 s at 44.1 kHz. Samples that do
+    // not fit are dropped
+    SpscRing<s16, 32768> sample_ring;
+
+    // Rate control state: ring fill averaged over ~half a second, since the
+    // device drains it a whole chunk at a time
+    double fill_average = static_cast<double>(TARGET_FILL);
+    double rate_integral = 0.0;
+    std::atomic<double> rate_scale{1.0};
 
     // DC-block filter state
     float dc_prev_input = 0.0f;
     float dc_prev_output = 0.0f;
     static constexpr float DC_BLOCK_R = 0.995f;
-
-    static const size_t MAX_BUFFER_SIZE = SAMPLE_RATE; // 1 second buffer
 };
 
 #endif // SOUND_H
@@ -0,0 +1,84 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+// Wait-free single-producer/single-consumer ring of trivially copyable
+// elements, e.g. audio samples.
+//
+// Capacity is a power of two so positions wrap with a mask. The read and
+// write positions only ever grow and each is stored by one side alone, so
+// write() and read() never block each other; blocks are moved with at most
+// two memcpy calls. When the ring is full, write() drops what does not fit.
+template <typename T, size_t CAPACITY>
+class SpscRing {
+    static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0, "capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "elements are copied with memcpy");
+
+public:
+    SpscRing() : write_pos(0), read_pos(0) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer side; returns how many elements were stored
+    size_t write(const T* data, size_t count)
+    {
+        const size_t pos = write_pos.load(std::memory_order_relaxed);
+        const size_t free = CAPACITY - (pos - read_pos.load(std::memory_order_acquire));
+        if (count > free) {
+            count = free;
+        }
+        copyIn(pos & MASK, data, count);
+        write_pos.store(pos + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer side; returns how many elements were copied to `out`
+    size_t read(T* out, size_t count)
+    {
+        const size_t pos = read_pos.load(std::memory_order_relaxed);
+        const size_t available = write_pos.load(std::memory_order_acquire) - pos;
+        if (count > available) {
+            count = available;
+        }
+        copyOut(pos & MASK, out, count);
+        read_pos.store(pos + count, std::memory_order_release);
+        return count;
+    }
+
+    // Elements waiting to be read (a snapshot when called from the producer)
+    size_t size() const
+    {
+        return write_pos.load(std::memory_order_acquire) - read_pos.load(std::memory_order_acquire);
+    }
+
+    static constexpr size_t capacity() { return CAPACITY; }
+
+private:
+    static const size_t MASK = CAPACITY - 1;
+
+    void copyIn(size_t index, const T* data, size_t count)
+    {
+        const size_t first = count < CAPACITY - index ? count : CAPACITY - index;
+        std::memcpy(buffer + index, data, first * sizeof(T));
+        std::memcpy(buffer, data + first, (count - first) * sizeof(T));
+    }
+
+    void copyOut(size_t index, T* out, size_t count) const
+    {
+        const size_t first = count < CAPACITY - index ? count : CAPACITY - index;
+        std::memcpy(out, buffer + index, first * sizeof(T));
+        std::memcpy(out + first, buffer, (count - first) * sizeof(T));
+    }
+
+    T buffer[CAPACITY];
+    // Each position is written by one side only; kept on separate cache lines
+    alignas(64) std::atomic<size_t> write_pos;
+    alignas(64) std::atomic<size_t> read_pos;
+};
+
+#endif // SPSC_RING_H
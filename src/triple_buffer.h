@@ -0,0 +1,53 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <array>
+#include <atomic>
+
+// Lock-free single-producer/single-consumer triple buffer.
+//
+// The producer fills back() and publish()es it; the consumer take()s the
+// newest published slot as front(). Each side owns one slot and the third
+// sits in an atomic hand-off index, so publishing and taking are a single
+// exchange and nothing is copied. A slot published before the consumer took
+// the previous one replaces it: frames are dropped rather than queued.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : back_slot(0), front_slot(1), ready(2) {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Producer side
+    T& back() { return slots[back_slot]; }
+    void publish()
+    {
+        back_slot = ready.exchange(back_slot | FRESH, std::memory_order_acq_rel) & SLOT_MASK;
+    }
+
+    // Consumer side; take() returns false when nothing new was published
+    T& front() { return slots[front_slot]; }
+    bool take()
+    {
+        if (!(ready.load(std::memory_order_relaxed) & FRESH)) {
+            return false;
+        }
+        front_slot = ready.exchange(front_slot, std::memory_order_acq_rel) & SLOT_MASK;
+        return true;
+    }
+
+    // All three slots, for sizing them before either side starts
+    std::array<T, 3>& all() { return slots; }
+
+private:
+    static const unsigned SLOT_MASK = 3;
+    static const unsigned FRESH = 4;    // set in `ready` until taken
+
+    std::array<T, 3> slots;
+    unsigned back_slot;                 // producer's
+    unsigned front_slot;                // consumer's
+    std::atomic<unsigned> ready;        // hand-off slot | FRESH
+};
+
+#endif // TRIPLE_BUFFER_H
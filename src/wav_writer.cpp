@@ -0,0 +1,93 @@
+#include "wav_writer.h"
+
+WavWriter::WavWriter(unsigned int sampleRate)
+    : sample_rate(sampleRate)
+    , sample_count(0)
+{
+}
+
+WavWriter::~WavWriter()
+{
+    close();
+}
+
+bool WavWriter::open(const std::string& path)
+{
+    close();
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+
+    sample_count = 0;
+    dc_prev_input = 0.0f;
+    dc_prev_output = 0.0f;
+
+    // Placeholder header, patched with the real sizes in close()
+    writeHeader(0);
+    return true;
+}
+
+void WavWriter::close()
+{
+    if (!file.is_open()) {
+        return;
+    }
+
+    file.seekp(0);
+    writeHeader(static_cast<u32>(sample_count * sizeof(s16)));
+    file.close();
+}
+
+void WavWriter::pushSamples(const float* samples, size_t count)
+{
+    if (!file.is_open()) {
+        return;
+    }
+
+    pcm_block.resize(count * 2);
+    for (size_t i = 0; i < count; i++) {
+        float filtered = samples[i] - dc_prev_input + (DC_BLOCK_R * dc_prev_output);
+        dc_prev_input = samples[i];
+        dc_prev_output = filtered;
+
+        if (filtered > 1.0f) filtered = 1.0f;
+        if (filtered < -1.0f) filtered = -1.0f;
+
+        const s16 pcm = static_cast<s16>(filtered * 32767.0f);
+        pcm_block[i * 2] = static_cast<u8>(pcm & 0xFF);
+        pcm_block[i * 2 + 1] = static_cast<u8>((pcm >> 8) & 0xFF);
+    }
+    file.write(reinterpret_cast<const char*>(pcm_block.data()), static_cast<std::streamsize>(pcm_block.size()));
+    sample_count += count;
+}
+
+void WavWriter::writeHeader(u32 dataBytes)
+{
+    auto put32 = [this](u32 v) {
+        const u8 b[4] = { static_cast<u8>(v), static_cast<u8>(v >> 8), static_cast<u8>(v >> 16), static_cast<u8>(v >> 24) };
+        file.write(reinterpret_cast<const char*>(b), sizeof(b));
+    };
+    auto put16 = [this](u16 v) {
+        const u8 b[2] = { static_cast<u8>(v), static_cast<u8>(v >> 8) };
+        file.write(reinterpret_cast<const char*>(b), sizeof(b));
+    };
+
+    const u16 channels = 1;
+    const u16 bitsPerSample = 16;
+    const u16 blockAlign = channels * bitsPerSample / 8;
+
+    file.write("RIFF", 4);
+    put32(36 + dataBytes);
+    file.write("WAVE", 4);
+    file.write("fmt ", 4);
+    put32(16);                              // PCM fmt chunk size
+    put16(1);                               // PCM format
+    put16(channels);
+    put32(sample_rate);
+    put32(sample_rate * blockAlign);        // Byte rate
+    put16(blockAlign);
+    put16(bitsPerSample);
+    file.write("data", 4);
+    put32(dataBytes);
+}
@@ -0,0 +1,40 @@
+#ifndef WAV_WRITER_H
+#define WAV_WRITER_H
+
+#include "types.h"
+#include "audio_sink.h"
+#include <fstream>
+#include <string>
+#include <vector>
+
+// AudioSink that streams 16-bit mono PCM into a .wav file.
+// Used by the headless runner to capture audio without an audio device.
+class WavWriter : public AudioSink {
+public:
+    explicit WavWriter(unsigned int sampleRate = 44100);
+    ~WavWriter();
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return file.is_open(); }
+
+    void pushSamples(const float* samples, size_t count) override;
+
+    u64 getSampleCount() const { return sample_count; }
+
+private:
+    void writeHeader(u32 dataBytes);
+
+    std::ofstream file;
+    unsigned int sample_rate;
+    u64 sample_count;
+
+    // Same DC-block filter as Sound so captures match what is heard
+    float dc_prev_input = 0.0f;
+    float dc_prev_output = 0.0f;
+    static constexpr float DC_BLOCK_R = 0.995f;
+
+    std::vector<u8> pcm_block;  // little-endian PCM of the current block
+};
+
+#endif // WAV_WRITER_H
@@ -0,0 +1,96 @@
+#include "worker_pool.h"
+
+WorkerPool::WorkerPool(unsigned threads)
+    : task(nullptr)
+    , task_count(0)
+    , next_task(0)
+    , remaining(0)
+    , stopping(false)
+{
+    start(threads);
+}
+
+WorkerPool::~WorkerPool()
+{
+    stop();
+}
+
+void WorkerPool::start(unsigned threads)
+{
+    stopping = false;
+    for (unsigned i = 1; i < threads; i++) {
+        workers.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+void WorkerPool::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    work_cv.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
+
+void WorkerPool::setThreadCount(unsigned threads)
+{
+    if (threads == 0) threads = 1;
+    if (threads == getThreadCount()) return;
+
+    stop();
+    start(threads);
+}
+
+void WorkerPool::run(unsigned count, const std::function<void(unsigned)>& job)
+{
+    if (workers.empty() || count <= 1) {
+        for (unsigned i = 0; i < count; i++) {
+            job(i);
+        }
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    task = &job;
+    task_count = count;
+    next_task = 0;
+    remaining = count;
+    work_cv.notify_all();
+
+    // The calling thread takes tasks too, then waits for the stragglers
+    while (next_task < task_count) {
+        const unsigned index = next_task++;
+        lock.unlock();
+        job(index);
+        lock.lock();
+        remaining--;
+    }
+    done_cv.wait(lock, [this] { return remaining == 0; });
+
+    task = nullptr;
+    task_count = 0;
+    next_task = 0;
+}
+
+void WorkerPool::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        work_cv.wait(lock, [this] { return stopping || next_task < task_count; });
+        if (stopping) return;
+
+        const unsigned index = next_task++;
+        const std::function<void(unsigned)>* job = task;
+        lock.unlock();
+        (*job)(index);
+        lock.lock();
+
+        if (--remaining == 0) {
+            done_cv.notify_all();
+        }
+    }
+}
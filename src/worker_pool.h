@@ -0,0 +1,51 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small persistent thread pool for data-parallel jobs such as scaling a
+// frame in horizontal bands.
+//
+// run() hands tasks 0..count-1 to the workers and works on them from the
+// calling thread as well, then blocks until every task has finished, so a
+// job costs a wake-up rather than a thread start. Tasks are meant to be
+// coarse (a few per frame), so they are handed out under the pool mutex.
+class WorkerPool {
+public:
+    // `threads` counts the calling thread, so threads - 1 workers are started
+    explicit WorkerPool(unsigned threads);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Restart with a different number of threads; not while run() is active
+    void setThreadCount(unsigned threads);
+    unsigned getThreadCount() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+    // Call task(i) for every i in [0, count) and wait for all of them
+    void run(unsigned count, const std::function<void(unsigned)>& task);
+
+private:
+    void start(unsigned threads);
+    void stop();
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable work_cv;
+    std::condition_variable done_cv;
+
+    // Current job, guarded by `mutex`
+    const std::function<void(unsigned)>* task;
+    unsigned task_count;
+    unsigned next_task;
+    unsigned remaining;     // tasks handed out or pending that have not finished
+    bool stopping;
+};
+
+#endif // WORKER_POOL_H